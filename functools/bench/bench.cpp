@@ -5,6 +5,7 @@
 #include <sys/resource.h>
 #include <sys/times.h>
 
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <cassert>
@@ -12,7 +13,7 @@
 #include <sstream>
 #include <fstream>
 
-#if !defined(native_REALISATION)
+#if !defined(native_REALISATION) && !defined(native_simd_REALISATION)
 using namespace NFuncTools;
 #endif
 
@@ -67,7 +68,14 @@ void InitData() {
 int BenchEnumerate() {
     int res = 0;
     for (int i = 0; i < metaIterations; ++i) {
-        #if !defined(native_REALISATION)
+        #if defined(ordinary_view_REALISATION)
+            ForEach(Enumerate(a), [&](auto t) {
+                auto [j, aj] = t;
+                res += i ^ j * aj;
+            });
+        #elif defined(native_simd_REALISATION)
+            res += NNativeSimd::SumXorIndexProduct(a.data(), a.size(), i);
+        #elif !defined(native_REALISATION)
             for (auto [j, aj] : Enumerate(a)) {
                 res += i ^ j * aj;
             }
@@ -84,7 +92,14 @@ int BenchEnumerate() {
 int BenchZip() {
     int res = 0;
     for (int i = 0; i < metaIterations; ++i) {
-        #if !defined(native_REALISATION)
+        #if defined(ordinary_view_REALISATION)
+            ForEach(Zip(a, b), [&](auto t) {
+                auto [aj, bj] = t;
+                res += i ^ aj * bj;
+            });
+        #elif defined(native_simd_REALISATION)
+            res += NNativeSimd::SumXorProduct(a.data(), b.data(), std::min(a.size(), b.size()), i);
+        #elif !defined(native_REALISATION)
             #if !defined(boost_range_REALISATION)
                 for (auto [aj, bj] : Zip(a, b)) {
                     res += i ^ aj * bj;
@@ -111,7 +126,13 @@ int BenchFilter() {
         return bool(x & 1);
     };
     for (int i = 0; i < metaIterations; ++i) {
-        #if !defined(native_REALISATION)
+        #if defined(ordinary_view_REALISATION)
+            ForEach(Filter(pred, a), [&](auto aj) {
+                res += i ^ aj;
+            });
+        #elif defined(native_simd_REALISATION)
+            res += NNativeSimd::SumXorOdd(a.data(), a.size(), i);
+        #elif !defined(native_REALISATION)
             for (auto aj : Filter(pred, a)) {
                 res += i ^ aj;
             }
@@ -131,7 +152,14 @@ int BenchFilter() {
 int BenchCartesianProduct() {
     int res = 0;
     for (int i = 0; i < metaIterations; ++i) {
-        #if !defined(native_REALISATION)
+        #if defined(ordinary_view_REALISATION)
+            ForEach(CartesianProduct(c, d), [&](auto t) {
+                auto [aj, bj] = t;
+                res += i ^ aj * bj;
+            });
+        #elif defined(native_simd_REALISATION)
+            res += NNativeSimd::SumXorOuterProduct(c.data(), c.size(), d.data(), d.size(), i);
+        #elif !defined(native_REALISATION)
             for (auto [aj, bj] : CartesianProduct(c, d)) {
                 res += i ^ aj * bj;
             }
@@ -152,7 +180,14 @@ int BenchCartesianProduct() {
 int BenchConcatenate() {
     int res = 0;
     for (int i = 0; i < metaIterations; ++i) {
-        #if !defined(native_REALISATION)
+        #if defined(ordinary_view_REALISATION)
+            ForEach(Concatenate(a, b), [&](auto x) {
+                res += i ^ x;
+            });
+        #elif defined(native_simd_REALISATION)
+            res += NNativeSimd::SumXor(a.data(), a.size(), i);
+            res += NNativeSimd::SumXor(b.data(), b.size(), i);
+        #elif !defined(native_REALISATION)
             for (auto x : Concatenate(a, b)) {
                 res += i ^ x;
             }
@@ -1,8 +1,9 @@
 #include <functools.h>
+#include <algorithm>
 #include <vector>
 
 
-#if !defined(native_REALISATION)
+#if !defined(native_REALISATION) && !defined(native_simd_REALISATION)
 using namespace NFuncTools;
 #endif
 
@@ -10,7 +11,14 @@ using namespace NFuncTools;
 #if defined(BenchEnumerate_BENCH)
 int BenchEnumerate(const std::vector<int>& a) {
     int res = 0;
-    #if !defined(native_REALISATION)
+    #if defined(ordinary_view_REALISATION)
+        ForEach(Enumerate(a), [&](auto t) {
+            auto [j, aj] = t;
+            res += j * aj;
+        });
+    #elif defined(native_simd_REALISATION)
+        res = NNativeSimd::SumXorIndexProduct(a.data(), a.size(), 0);
+    #elif !defined(native_REALISATION)
         for (auto [j, aj] : Enumerate(a)) {
             res += j * aj;
         }
@@ -26,7 +34,14 @@ int BenchEnumerate(const std::vector<int>& a) {
 #if defined(BenchZip_BENCH)
 int BenchZip(const std::vector<int>& a, const std::vector<int>& b) {
     int res = 0;
-    #if !defined(native_REALISATION)
+    #if defined(ordinary_view_REALISATION)
+        ForEach(Zip(a, b), [&](auto t) {
+            auto [aj, bj] = t;
+            res += aj * bj;
+        });
+    #elif defined(native_simd_REALISATION)
+        res = NNativeSimd::SumXorProduct(a.data(), b.data(), std::min(a.size(), b.size()), 0);
+    #elif !defined(native_REALISATION)
         #if !defined(boost_range_REALISATION)
             for (auto [aj, bj] : Zip(a, b)) {
                 res += aj * bj;
@@ -53,7 +68,13 @@ int BenchFilter(const std::vector<int>& a) {
     auto pred = [](auto x) {
         return bool(x & 1);
     };
-    #if !defined(native_REALISATION)
+    #if defined(ordinary_view_REALISATION)
+        ForEach(Filter(pred, a), [&](auto aj) {
+            res += aj;
+        });
+    #elif defined(native_simd_REALISATION)
+        res = NNativeSimd::SumXorOdd(a.data(), a.size(), 0);
+    #elif !defined(native_REALISATION)
         for (auto aj : Filter(pred, a)) {
             res += aj;
         }
@@ -71,7 +92,14 @@ int BenchFilter(const std::vector<int>& a) {
 #if defined(BenchCartesianProduct_BENCH)
 int BenchCartesianProduct(const std::vector<int>& a, const std::vector<int>& b) {
     int res = 0;
-    #if !defined(native_REALISATION)
+    #if defined(ordinary_view_REALISATION)
+        ForEach(CartesianProduct(a, b), [&](auto t) {
+            auto [aj, bj] = t;
+            res += aj * bj;
+        });
+    #elif defined(native_simd_REALISATION)
+        res = NNativeSimd::SumXorOuterProduct(a.data(), a.size(), b.data(), b.size(), 0);
+    #elif !defined(native_REALISATION)
         for (auto [aj, bj] : CartesianProduct(a, b)) {
             res += aj * bj;
         }
@@ -90,7 +118,13 @@ int BenchCartesianProduct(const std::vector<int>& a, const std::vector<int>& b)
 #if defined(BenchConcatenate_BENCH)
 int BenchConcatenate(const std::vector<int>& a, const std::vector<int>& b) {
     int res = 0;
-    #if !defined(native_REALISATION)
+    #if defined(ordinary_view_REALISATION)
+        ForEach(Concatenate(a, b), [&](auto x) {
+            res += x;
+        });
+    #elif defined(native_simd_REALISATION)
+        res = NNativeSimd::SumXor(a.data(), a.size(), 0) + NNativeSimd::SumXor(b.data(), b.size(), 0);
+    #elif !defined(native_REALISATION)
         for (auto x : Concatenate(a, b)) {
             res += x;
         }
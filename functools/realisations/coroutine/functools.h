@@ -0,0 +1,269 @@
+#pragma once
+
+#include "generator.h"
+
+#include <store_policy.h>
+
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+
+/** @file
+ * Realisation with C++20 coroutines: every adaptor is a generator coroutine.
+ * Adaptors keep their inputs in a creator lambda as baseline does, begin() starts a new coroutine,
+ * so the range can be iterated several times. Frames are recycled by TFrameAllocator.
+ * Requires -std=c++20.
+ */
+
+namespace NFuncTools::NPrivate {
+
+    //! Range which starts a new generator on every begin()
+    template <typename TGeneratorCreator>
+    class TCoroutineRange {
+        using TGeneratorType = decltype(std::declval<TGeneratorCreator&>()());
+
+    public:
+        using iterator = typename TGeneratorType::iterator;
+
+        TCoroutineRange(TGeneratorCreator&& generatorCreator)
+            : GeneratorCreator(std::move(generatorCreator))
+        {
+        }
+
+        iterator begin() {
+            return GeneratorCreator().begin();
+        }
+
+        TGeneratorSentinel end() {
+            return {};
+        }
+
+    protected:
+        TGeneratorCreator GeneratorCreator;
+    };
+
+    //! Return value is true when iteration is finished
+    template <std::size_t position, typename TIteratorsTuple, typename THoldersTuple>
+    bool IncrementIteratorsTuple(TIteratorsTuple& iteratorsTuple, THoldersTuple& holdersTuple) {
+        auto& currentIterator = std::get<position>(iteratorsTuple);
+        ++currentIterator;
+
+        if (!(currentIterator != std::get<position>(holdersTuple).Ptr()->end())) {
+            currentIterator = std::get<position>(holdersTuple).Ptr()->begin();
+            if constexpr (position == 0) {
+                return true;
+            } else {
+                return IncrementIteratorsTuple<position - 1>(iteratorsTuple, holdersTuple);
+            }
+        } else {
+            return false;
+        }
+    }
+
+    template <typename TValue, std::size_t index = 0, typename TIters>
+    TValue GetCurrentValue(std::size_t position, TIters& iters) {
+        if constexpr (index + 1 >= std::tuple_size_v<TIters>) {
+            return *std::get<index>(iters);
+        } else {
+            if (position == index) {
+                return *std::get<index>(iters);
+            } else {
+                return GetCurrentValue<TValue, index + 1>(position, iters);
+            }
+        }
+    }
+
+    template <bool needIncrement, std::size_t index = 0, typename TIters, typename THolders>
+    void MaybeIncrementIteratorAndSkipExhaustedContainers(std::size_t& position, TIters& iters, THolders& holders) {
+        if constexpr (index >= std::tuple_size_v<TIters>) {
+            return;
+        } else {
+            if (position == index) {
+                if constexpr (needIncrement) {
+                    ++std::get<index>(iters);
+                }
+                if (!(std::get<index>(iters) != std::get<index>(holders).Ptr()->end())) {
+                    ++position;
+                    MaybeIncrementIteratorAndSkipExhaustedContainers<false, index + 1>(position, iters, holders);
+                }
+            } else {
+                MaybeIncrementIteratorAndSkipExhaustedContainers<needIncrement, index + 1>(position, iters, holders);
+            }
+        }
+    }
+
+    struct TTupleRecursiveFlattener {
+
+        template <class TObject, std::size_t... I>
+        auto FlattenTuple(TObject&& object, std::index_sequence<I...>) {
+            return std::tuple_cat(Flatten(std::get<I>(std::forward<TObject>(object)), 0u)...);
+        }
+
+        template <class TObject,
+                  size_t Size = std::tuple_size<typename std::decay<TObject>::type>::value>
+        auto Flatten(TObject&& object, uint32_t) {
+            auto indexes = std::make_index_sequence<Size>{};
+            return FlattenTuple(std::forward<TObject>(object), indexes);
+        }
+
+        template <class TObject>
+        auto Flatten(TObject&& object, char) {
+            return std::tuple<TObject>(std::forward<TObject>(object));
+        }
+
+        template <class TObject>
+        auto operator()(TObject&& object) {
+            return Flatten(std::forward<TObject>(object), 0u);
+        }
+
+    };
+}
+
+namespace NFuncTools {
+    //! Custom adaptors are written the same way: for (auto x : Squares(a)) {...}
+    //! TGenerator<int> Squares(const std::vector<int>& a) { for (int x : a) { co_yield x * x; } }
+    template <typename TReference>
+    using TGenerator = NPrivate::TGenerator<TReference>;
+
+    //! Usage: for (auto [i, x] : Enumerate(container)) {...}
+    template <typename TContainerOrRef>
+    auto Enumerate(TContainerOrRef&& container) {
+        using TValue = std::tuple<const std::size_t&, decltype(*container.begin())>;
+
+        return NPrivate::TCoroutineRange(
+            [holder = TAutoEmbedOrPtrPolicy<TContainerOrRef>{container}]() mutable -> TGenerator<TValue> {
+                std::size_t i = 0;
+                for (auto iter = holder.Ptr()->begin(); iter != holder.Ptr()->end(); ++iter, ++i) {
+                    co_yield TValue(i, *iter);
+                }
+            });
+    }
+
+    template <typename TContainerOrRef>
+    auto Reversed(TContainerOrRef&& container) {
+        return NPrivate::TCoroutineRange(
+            [holder = TAutoEmbedOrPtrPolicy<TContainerOrRef>{container}]() mutable -> TGenerator<decltype(*container.rbegin())> {
+                for (auto iter = holder.Ptr()->rbegin(); iter != holder.Ptr()->rend(); ++iter) {
+                    co_yield *iter;
+                }
+            });
+    }
+
+    template <typename TValue>
+    auto Range(TValue from, TValue to, TValue step) {
+        return NPrivate::TCoroutineRange(
+            [=]() -> TGenerator<TValue> {
+                for (TValue i = from; i < to; i += step) {
+                    co_yield i;
+                }
+            });
+    }
+
+    template <typename TValue>
+    auto Range(TValue from, TValue to) {
+        return Range(from, to, TValue{1});
+    }
+
+    template <typename TValue>
+    auto Range(TValue to) {
+        return Range(TValue{0}, to, TValue{1});
+    }
+
+    //! Acts as pythonic zip, BUT result length is equal to shortest lenght of input containers
+    //! Usage: for (auto [ai, bi, ci] : Zip(a, b, c)) {...}
+    template <typename... TContainers>
+    auto Zip(TContainers&&... containers) {
+        using TValue = std::tuple<decltype(*containers.begin())...>;
+
+        return NPrivate::TCoroutineRange(
+            [holders = std::tuple{TAutoEmbedOrPtrPolicy<TContainers>(containers)...}]() mutable -> TGenerator<TValue> {
+                auto iters = std::apply([](auto&... holder) { return std::tuple{holder.Ptr()->begin()...}; }, holders);
+                auto notEnd = [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return ((std::get<I>(iters) != std::get<I>(holders).Ptr()->end()) && ...);
+                };
+                constexpr auto indexes = std::index_sequence_for<TContainers...>{};
+                while (notEnd(indexes)) {
+                    co_yield std::apply([](auto&... iter) { return TValue(*iter...); }, iters);
+                    std::apply([](auto&... iter) { (++iter, ...); }, iters);
+                }
+            });
+    }
+
+    //! Usage: for (i32 x : Map([](i32 x) { return x * x; }, a)) {...}
+    template <typename TMapper, typename TContainerOrRef>
+    auto Map(TMapper&& mapper, TContainerOrRef&& container) {
+        using TValue = decltype(mapper(*container.begin()));
+
+        return NPrivate::TCoroutineRange(
+            [holder = TAutoEmbedOrPtrPolicy<TContainerOrRef>{container}, mapper = std::move(mapper)]() mutable -> TGenerator<TValue> {
+                for (auto iter = holder.Ptr()->begin(); iter != holder.Ptr()->end(); ++iter) {
+                    co_yield mapper(*iter);
+                }
+            });
+    }
+
+    //! Usage: for (auto i : Map<int>(floats)) {...}
+    template <typename TMapResult, typename TContainerOrRef>
+    auto Map(TContainerOrRef&& container) {
+        return Map([](const auto& x) { return TMapResult(x); }, std::forward<TContainerOrRef>(container));
+    }
+
+    //! Usage: for (i32 x : Filter(predicate, container)) {...}
+    template <typename TPredicate, typename TContainerOrRef>
+    auto Filter(TPredicate&& predicate, TContainerOrRef&& container) {
+        return NPrivate::TCoroutineRange(
+            [holder = TAutoEmbedOrPtrPolicy<TContainerOrRef>{container}, predicate = std::move(predicate)]() mutable
+                -> TGenerator<decltype(*container.begin())> {
+                for (auto iter = holder.Ptr()->begin(); iter != holder.Ptr()->end(); ++iter) {
+                    if (predicate(*iter)) {
+                        co_yield *iter;
+                    }
+                }
+            });
+    }
+
+    //! Usage: for (auto [ai, bi] : CartesianProduct(a, b)) {...}
+    //! Equivalent: for (auto& ai : a) { for (auto& bi : b) {...} }
+    template <typename... TContainers>
+    auto CartesianProduct(TContainers&&... containers) {
+        using TValue = std::tuple<decltype(*containers.begin())...>;
+
+        return NPrivate::TCoroutineRange(
+            [holders = std::tuple{TAutoEmbedOrPtrPolicy<TContainers>(containers)...}]() mutable -> TGenerator<TValue> {
+                auto iters = std::apply([](auto&... holder) { return std::tuple{holder.Ptr()->begin()...}; }, holders);
+                bool finished = [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return !((std::get<I>(iters) != std::get<I>(holders).Ptr()->end()) && ...);
+                }(std::index_sequence_for<TContainers...>{});
+                while (!finished) {
+                    co_yield std::apply([](auto&... iter) { return TValue(*iter...); }, iters);
+                    finished = NPrivate::IncrementIteratorsTuple<sizeof...(TContainers) - 1>(iters, holders);
+                }
+            });
+    }
+
+    //! Usage: for (auto x : Concatenate(a, b)) {...}
+    template <typename TFirstContainer, typename... TContainers>
+    auto Concatenate(TFirstContainer&& container, TContainers&&... containers) {
+        using TValue = decltype(*container.begin());
+
+        return NPrivate::TCoroutineRange(
+            [holders = std::tuple{TAutoEmbedOrPtrPolicy<TFirstContainer>(container), TAutoEmbedOrPtrPolicy<TContainers>(containers)...}]() mutable
+                -> TGenerator<TValue> {
+                auto iters = std::apply([](auto&... holder) { return std::tuple{holder.Ptr()->begin()...}; }, holders);
+                std::size_t position = 0;
+                NPrivate::MaybeIncrementIteratorAndSkipExhaustedContainers<false>(position, iters, holders);
+                while (position < sizeof...(TContainers) + 1) {
+                    co_yield NPrivate::GetCurrentValue<TValue>(position, iters);
+                    NPrivate::MaybeIncrementIteratorAndSkipExhaustedContainers<true>(position, iters, holders);
+                }
+            });
+    }
+
+    //! Usage: for (auto [i, ai, bi] : Flatten(Enumerate(Zip(a, b))) {...}
+    template <typename TContainerOrRef>
+    auto Flatten(TContainerOrRef&& container) {
+        return Map(NPrivate::TTupleRecursiveFlattener{}, std::forward<TContainerOrRef>(container));
+    }
+
+}
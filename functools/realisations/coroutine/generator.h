@@ -0,0 +1,249 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+/** @file
+ * Minimal std::generator-like coroutine type for the coroutine realisation.
+ * Frames are allocated by TFrameAllocator: freed frames are kept in per-thread free lists by size class,
+ * so after the first iteration of a loop no heap allocation happens per range.
+ * Clang may additionally elide the allocation (HALO) when the generator does not outlive the caller.
+ */
+
+namespace NFuncTools::NPrivate {
+
+    //! Recycles coroutine frames, frames bigger than MaxPooledSize go to the global operator new
+    class TFrameAllocator {
+    public:
+        static constexpr std::size_t Granularity = 64;
+        static constexpr std::size_t MaxPooledSize = 4096;
+
+        static void* Allocate(std::size_t size) {
+            if (size > MaxPooledSize) {
+                return ::operator new(size);
+            }
+            TFreeFrame*& head = FreeLists().Heads[SizeClass(size)];
+            if (head) {
+                return std::exchange(head, head->Next);
+            }
+            return ::operator new((SizeClass(size) + 1) * Granularity);
+        }
+
+        static void Deallocate(void* frame, std::size_t size) noexcept {
+            if (size > MaxPooledSize) {
+                ::operator delete(frame);
+                return;
+            }
+            TFreeFrame*& head = FreeLists().Heads[SizeClass(size)];
+            head = new (frame) TFreeFrame{head};
+        }
+
+    private:
+        struct TFreeFrame {
+            TFreeFrame* Next;
+        };
+
+        struct TFreeLists {
+            TFreeFrame* Heads[MaxPooledSize / Granularity] = {};
+
+            ~TFreeLists() {
+                for (TFreeFrame* head : Heads) {
+                    while (head) {
+                        ::operator delete(std::exchange(head, head->Next));
+                    }
+                }
+            }
+        };
+
+        static std::size_t SizeClass(std::size_t size) {
+            return (size + Granularity - 1) / Granularity - 1;
+        }
+
+        static TFreeLists& FreeLists() {
+            static thread_local TFreeLists freeLists;
+            return freeLists;
+        }
+    };
+
+    //! Sentinel of TGenerator
+    struct TGeneratorSentinel {
+    };
+
+    //! Lazy single pass sequence of TReference produced by co_yield
+    //! References are yielded without copying, values are kept in the frame until the next resumption
+    template <typename TReference>
+    class TGenerator {
+        using TValue = std::remove_cv_t<std::remove_reference_t<TReference>>;
+        using TPointer = std::add_pointer_t<std::remove_reference_t<TReference>>;
+
+    public:
+        class promise_type {
+        public:
+            TGenerator get_return_object() noexcept {
+                return TGenerator{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            std::suspend_always final_suspend() const noexcept {
+                return {};
+            }
+
+            template <typename TYielded>
+                requires (std::is_reference_v<TReference> && std::is_convertible_v<TYielded*, TPointer>)
+            std::suspend_always yield_value(TYielded& value) noexcept {
+                Current_ = std::addressof(value);
+                return {};
+            }
+
+            //! The value is kept in the awaiter, which lives in the frame while the coroutine is suspended
+            template <typename TYielded>
+                requires (!std::is_reference_v<TReference>)
+            auto yield_value(TYielded&& value) {
+                struct TValueAwaiter {
+                    TValue Value_;
+                    promise_type* Promise_;
+
+                    bool await_ready() const noexcept {
+                        return false;
+                    }
+                    void await_suspend(std::coroutine_handle<>) noexcept {
+                        Promise_->Current_ = std::addressof(Value_);
+                    }
+                    void await_resume() const noexcept {
+                    }
+                };
+                return TValueAwaiter{TValue(std::forward<TYielded>(value)), this};
+            }
+
+            void return_void() const noexcept {
+            }
+
+            void unhandled_exception() noexcept {
+                Exception_ = std::current_exception();
+            }
+
+            void RethrowIfFailed() {
+                if (Exception_) {
+                    std::rethrow_exception(std::exchange(Exception_, nullptr));
+                }
+            }
+
+            static void* operator new(std::size_t size) {
+                return TFrameAllocator::Allocate(size);
+            }
+
+            static void operator delete(void* frame, std::size_t size) noexcept {
+                TFrameAllocator::Deallocate(frame, size);
+            }
+
+            TPointer Current_ = nullptr;
+
+        private:
+            std::exception_ptr Exception_;
+        };
+
+        using THandle = std::coroutine_handle<promise_type>;
+
+        //! Owns the frame: the generator gives it to the iterator in begin()
+        class iterator {
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = TValue;
+            using pointer = TPointer;
+            using reference = TReference;
+            using iterator_category = std::input_iterator_tag;
+
+            //! Runs the coroutine up to the first co_yield
+            explicit iterator(THandle handle)
+                : Handle_(handle)
+            {
+                Resume();
+            }
+
+            iterator(iterator&& other) noexcept
+                : Handle_(std::exchange(other.Handle_, nullptr))
+            {
+            }
+
+            iterator& operator=(iterator&& other) noexcept {
+                std::swap(Handle_, other.Handle_);
+                return *this;
+            }
+
+            ~iterator() {
+                if (Handle_) {
+                    Handle_.destroy();
+                }
+            }
+
+            TReference operator*() const {
+                return static_cast<TReference>(*Handle_.promise().Current_);
+            }
+
+            iterator& operator++() {
+                Resume();
+                return *this;
+            }
+
+            bool operator!=(TGeneratorSentinel) const {
+                return !Handle_.done();
+            }
+
+            bool operator==(TGeneratorSentinel) const {
+                return Handle_.done();
+            }
+
+        private:
+            void Resume() {
+                Handle_.resume();
+                Handle_.promise().RethrowIfFailed();
+            }
+
+            THandle Handle_;
+        };
+
+        TGenerator(TGenerator&& other) noexcept
+            : Handle_(std::exchange(other.Handle_, nullptr))
+        {
+        }
+
+        TGenerator& operator=(TGenerator other) noexcept {
+            std::swap(Handle_, other.Handle_);
+            return *this;
+        }
+
+        ~TGenerator() {
+            if (Handle_) {
+                Handle_.destroy();
+            }
+        }
+
+        //! Single pass: the frame is moved to the iterator
+        iterator begin() {
+            return iterator{std::exchange(Handle_, nullptr)};
+        }
+
+        TGeneratorSentinel end() const noexcept {
+            return {};
+        }
+
+    private:
+        explicit TGenerator(THandle handle)
+            : Handle_(handle)
+        {
+        }
+
+        THandle Handle_;
+    };
+
+}
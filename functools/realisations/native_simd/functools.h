@@ -0,0 +1,315 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <cstddef>
+#include <cstdint>
+
+
+/** @file
+ * There is no lib for native_simd realisation either: these are hand vectorized kernels of bench.cpp
+ * and compile_bench.cpp, an upper bound for the adaptor realisations.
+ * Every kernel has scalar, SSE4.1 and AVX2 versions, the best one supported by the CPU is chosen at runtime.
+ * Arithmetic wraps around as 32-bit unsigned, which is the result of the int loops of the native realisation.
+ */
+
+namespace NNativeSimd {
+
+    enum class EInstructionSet {
+        Scalar,
+        Sse41,
+        Avx2,
+    };
+
+    inline EInstructionSet DetectInstructionSet() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return EInstructionSet::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.1")) {
+            return EInstructionSet::Sse41;
+        }
+        return EInstructionSet::Scalar;
+    }
+
+    inline const EInstructionSet InstructionSet = DetectInstructionSet();
+
+    namespace NScalar {
+
+        inline uint32_t SumXor(const int32_t* a, std::size_t n, uint32_t x) {
+            uint32_t res = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                res += x ^ uint32_t(a[j]);
+            }
+            return res;
+        }
+
+        inline uint32_t SumXorOdd(const int32_t* a, std::size_t n, uint32_t x) {
+            uint32_t res = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                if (a[j] & 1) {
+                    res += x ^ uint32_t(a[j]);
+                }
+            }
+            return res;
+        }
+
+        inline uint32_t SumXorProduct(const int32_t* a, const int32_t* b, std::size_t n, uint32_t x) {
+            uint32_t res = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                res += x ^ (uint32_t(a[j]) * uint32_t(b[j]));
+            }
+            return res;
+        }
+
+        //! Starts numeration of elements from `first`, so the vector versions can finish the tail here
+        inline uint32_t SumXorIndexProduct(const int32_t* a, std::size_t n, uint32_t x, uint32_t first = 0) {
+            uint32_t res = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                res += x ^ ((first + uint32_t(j)) * uint32_t(a[j]));
+            }
+            return res;
+        }
+
+        inline uint32_t SumXorScaled(const int32_t* a, std::size_t n, uint32_t scale, uint32_t x) {
+            uint32_t res = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                res += x ^ (scale * uint32_t(a[j]));
+            }
+            return res;
+        }
+
+    }
+
+    namespace NSse41 {
+
+        __attribute__((target("sse4.1")))
+        inline uint32_t HorizontalSum(__m128i v) {
+            v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+            v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtsi128_si32(v);
+        }
+
+        __attribute__((target("sse4.1")))
+        inline __m128i Load(const int32_t* a) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        }
+
+        __attribute__((target("sse4.1")))
+        inline uint32_t SumXor(const int32_t* a, std::size_t n, uint32_t x) {
+            const __m128i xs = _mm_set1_epi32(x);
+            __m128i acc = _mm_setzero_si128();
+            std::size_t j = 0;
+            for (; j + 4 <= n; j += 4) {
+                acc = _mm_add_epi32(acc, _mm_xor_si128(xs, Load(a + j)));
+            }
+            return HorizontalSum(acc) + NScalar::SumXor(a + j, n - j, x);
+        }
+
+        __attribute__((target("sse4.1")))
+        inline uint32_t SumXorOdd(const int32_t* a, std::size_t n, uint32_t x) {
+            const __m128i xs = _mm_set1_epi32(x);
+            const __m128i ones = _mm_set1_epi32(1);
+            __m128i acc = _mm_setzero_si128();
+            std::size_t j = 0;
+            for (; j + 4 <= n; j += 4) {
+                const __m128i v = Load(a + j);
+                const __m128i odd = _mm_cmpeq_epi32(_mm_and_si128(v, ones), ones);
+                acc = _mm_add_epi32(acc, _mm_and_si128(odd, _mm_xor_si128(xs, v)));
+            }
+            return HorizontalSum(acc) + NScalar::SumXorOdd(a + j, n - j, x);
+        }
+
+        __attribute__((target("sse4.1")))
+        inline uint32_t SumXorProduct(const int32_t* a, const int32_t* b, std::size_t n, uint32_t x) {
+            const __m128i xs = _mm_set1_epi32(x);
+            __m128i acc = _mm_setzero_si128();
+            std::size_t j = 0;
+            for (; j + 4 <= n; j += 4) {
+                acc = _mm_add_epi32(acc, _mm_xor_si128(xs, _mm_mullo_epi32(Load(a + j), Load(b + j))));
+            }
+            return HorizontalSum(acc) + NScalar::SumXorProduct(a + j, b + j, n - j, x);
+        }
+
+        __attribute__((target("sse4.1")))
+        inline uint32_t SumXorIndexProduct(const int32_t* a, std::size_t n, uint32_t x) {
+            const __m128i xs = _mm_set1_epi32(x);
+            const __m128i step = _mm_set1_epi32(4);
+            __m128i indexes = _mm_setr_epi32(0, 1, 2, 3);
+            __m128i acc = _mm_setzero_si128();
+            std::size_t j = 0;
+            for (; j + 4 <= n; j += 4) {
+                acc = _mm_add_epi32(acc, _mm_xor_si128(xs, _mm_mullo_epi32(indexes, Load(a + j))));
+                indexes = _mm_add_epi32(indexes, step);
+            }
+            return HorizontalSum(acc) + NScalar::SumXorIndexProduct(a + j, n - j, x, j);
+        }
+
+        __attribute__((target("sse4.1")))
+        inline uint32_t SumXorScaled(const int32_t* a, std::size_t n, uint32_t scale, uint32_t x) {
+            const __m128i xs = _mm_set1_epi32(x);
+            const __m128i scales = _mm_set1_epi32(scale);
+            __m128i acc = _mm_setzero_si128();
+            std::size_t j = 0;
+            for (; j + 4 <= n; j += 4) {
+                acc = _mm_add_epi32(acc, _mm_xor_si128(xs, _mm_mullo_epi32(scales, Load(a + j))));
+            }
+            return HorizontalSum(acc) + NScalar::SumXorScaled(a + j, n - j, scale, x);
+        }
+
+    }
+
+    namespace NAvx2 {
+
+        __attribute__((target("avx2")))
+        inline uint32_t HorizontalSum(__m256i v) {
+            __m128i half = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+            half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+            half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtsi128_si32(half);
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i Load(const int32_t* a) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        }
+
+        __attribute__((target("avx2")))
+        inline uint32_t SumXor(const int32_t* a, std::size_t n, uint32_t x) {
+            const __m256i xs = _mm256_set1_epi32(x);
+            // two accumulators hide latency of the dependent additions
+            __m256i acc0 = _mm256_setzero_si256();
+            __m256i acc1 = _mm256_setzero_si256();
+            std::size_t j = 0;
+            for (; j + 16 <= n; j += 16) {
+                acc0 = _mm256_add_epi32(acc0, _mm256_xor_si256(xs, Load(a + j)));
+                acc1 = _mm256_add_epi32(acc1, _mm256_xor_si256(xs, Load(a + j + 8)));
+            }
+            for (; j + 8 <= n; j += 8) {
+                acc0 = _mm256_add_epi32(acc0, _mm256_xor_si256(xs, Load(a + j)));
+            }
+            return HorizontalSum(_mm256_add_epi32(acc0, acc1)) + NScalar::SumXor(a + j, n - j, x);
+        }
+
+        __attribute__((target("avx2")))
+        inline uint32_t SumXorOdd(const int32_t* a, std::size_t n, uint32_t x) {
+            const __m256i xs = _mm256_set1_epi32(x);
+            const __m256i ones = _mm256_set1_epi32(1);
+            __m256i acc = _mm256_setzero_si256();
+            std::size_t j = 0;
+            for (; j + 8 <= n; j += 8) {
+                const __m256i v = Load(a + j);
+                const __m256i odd = _mm256_cmpeq_epi32(_mm256_and_si256(v, ones), ones);
+                acc = _mm256_add_epi32(acc, _mm256_and_si256(odd, _mm256_xor_si256(xs, v)));
+            }
+            return HorizontalSum(acc) + NScalar::SumXorOdd(a + j, n - j, x);
+        }
+
+        __attribute__((target("avx2")))
+        inline uint32_t SumXorProduct(const int32_t* a, const int32_t* b, std::size_t n, uint32_t x) {
+            const __m256i xs = _mm256_set1_epi32(x);
+            __m256i acc = _mm256_setzero_si256();
+            std::size_t j = 0;
+            for (; j + 8 <= n; j += 8) {
+                acc = _mm256_add_epi32(acc, _mm256_xor_si256(xs, _mm256_mullo_epi32(Load(a + j), Load(b + j))));
+            }
+            return HorizontalSum(acc) + NScalar::SumXorProduct(a + j, b + j, n - j, x);
+        }
+
+        __attribute__((target("avx2")))
+        inline uint32_t SumXorIndexProduct(const int32_t* a, std::size_t n, uint32_t x) {
+            const __m256i xs = _mm256_set1_epi32(x);
+            const __m256i step = _mm256_set1_epi32(8);
+            __m256i indexes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            __m256i acc = _mm256_setzero_si256();
+            std::size_t j = 0;
+            for (; j + 8 <= n; j += 8) {
+                acc = _mm256_add_epi32(acc, _mm256_xor_si256(xs, _mm256_mullo_epi32(indexes, Load(a + j))));
+                indexes = _mm256_add_epi32(indexes, step);
+            }
+            return HorizontalSum(acc) + NScalar::SumXorIndexProduct(a + j, n - j, x, j);
+        }
+
+        __attribute__((target("avx2")))
+        inline uint32_t SumXorScaled(const int32_t* a, std::size_t n, uint32_t scale, uint32_t x) {
+            const __m256i xs = _mm256_set1_epi32(x);
+            const __m256i scales = _mm256_set1_epi32(scale);
+            __m256i acc = _mm256_setzero_si256();
+            std::size_t j = 0;
+            for (; j + 8 <= n; j += 8) {
+                acc = _mm256_add_epi32(acc, _mm256_xor_si256(xs, _mm256_mullo_epi32(scales, Load(a + j))));
+            }
+            return HorizontalSum(acc) + NScalar::SumXorScaled(a + j, n - j, scale, x);
+        }
+
+    }
+
+    //! sum of x ^ a[j]
+    //! BenchConcatenate is two calls of it
+    inline int32_t SumXor(const int32_t* a, std::size_t n, int32_t x) {
+        switch (InstructionSet) {
+            case EInstructionSet::Avx2:
+                return NAvx2::SumXor(a, n, x);
+            case EInstructionSet::Sse41:
+                return NSse41::SumXor(a, n, x);
+            default:
+                return NScalar::SumXor(a, n, x);
+        }
+    }
+
+    //! sum of x ^ a[j] over odd a[j] (BenchFilter)
+    inline int32_t SumXorOdd(const int32_t* a, std::size_t n, int32_t x) {
+        switch (InstructionSet) {
+            case EInstructionSet::Avx2:
+                return NAvx2::SumXorOdd(a, n, x);
+            case EInstructionSet::Sse41:
+                return NSse41::SumXorOdd(a, n, x);
+            default:
+                return NScalar::SumXorOdd(a, n, x);
+        }
+    }
+
+    //! sum of x ^ a[j] * b[j] (BenchZip)
+    inline int32_t SumXorProduct(const int32_t* a, const int32_t* b, std::size_t n, int32_t x) {
+        switch (InstructionSet) {
+            case EInstructionSet::Avx2:
+                return NAvx2::SumXorProduct(a, b, n, x);
+            case EInstructionSet::Sse41:
+                return NSse41::SumXorProduct(a, b, n, x);
+            default:
+                return NScalar::SumXorProduct(a, b, n, x);
+        }
+    }
+
+    //! sum of x ^ j * a[j] (BenchEnumerate)
+    inline int32_t SumXorIndexProduct(const int32_t* a, std::size_t n, int32_t x) {
+        switch (InstructionSet) {
+            case EInstructionSet::Avx2:
+                return NAvx2::SumXorIndexProduct(a, n, x);
+            case EInstructionSet::Sse41:
+                return NSse41::SumXorIndexProduct(a, n, x);
+            default:
+                return NScalar::SumXorIndexProduct(a, n, x);
+        }
+    }
+
+    //! sum of x ^ a[j] * b[k] over all pairs (BenchCartesianProduct), the inner loop over b is vectorized
+    inline int32_t SumXorOuterProduct(const int32_t* a, std::size_t n, const int32_t* b, std::size_t m, int32_t x) {
+        uint32_t res = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            switch (InstructionSet) {
+                case EInstructionSet::Avx2:
+                    res += NAvx2::SumXorScaled(b, m, a[j], x);
+                    break;
+                case EInstructionSet::Sse41:
+                    res += NSse41::SumXorScaled(b, m, a[j], x);
+                    break;
+                default:
+                    res += NScalar::SumXorScaled(b, m, a[j], x);
+                    break;
+            }
+        }
+        return res;
+    }
+
+}
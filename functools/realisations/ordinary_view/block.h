@@ -0,0 +1,333 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+/** @file
+ * Block-at-a-time (pull-based) iteration, as in vectorized query engines.
+ * A reader fills a block of up to BlockSize rows per call:
+ * Filter marks accepted rows in a selection vector instead of skipping them,
+ * Map transforms the whole block, Zip fills a column per container in lockstep
+ * and Concatenate refills the block across container borders.
+ * Readers with Dense = true fill every row and can append to a partly filled block.
+ * Adaptors without a block reader (and Zip or Concatenate of non-dense readers) are read by iterators.
+ */
+
+namespace NPrivate {
+
+    static constexpr std::size_t BlockSize = 1024;
+
+    //! Rows of a block that are passed on: all rows [0, Size_) or rows of the selection vector
+    struct TBlockRows {
+        std::size_t Size_ = 0;
+        std::size_t Selected_ = 0;
+        bool Dense_ = true;
+        std::array<uint16_t, BlockSize> Selection_;
+
+        void Clear() {
+            Size_ = 0;
+            Selected_ = 0;
+            Dense_ = true;
+        }
+
+        bool Full() const {
+            return Size_ == BlockSize;
+        }
+
+        std::size_t SelectedCount() const {
+            return Dense_ ? Size_ : Selected_;
+        }
+
+        template <typename TFunction>
+        void ForEachRow(TFunction&& fn) const {
+            if (Dense_) {
+                for (std::size_t row = 0; row < Size_; ++row) {
+                    fn(row);
+                }
+            } else {
+                for (std::size_t i = 0; i < Selected_; ++i) {
+                    fn(std::size_t(Selection_[i]));
+                }
+            }
+        }
+
+        //! Keeps selected rows for which condition(row) is true
+        template <typename TCondition>
+        void Select(TCondition&& condition) {
+            std::size_t selected = 0;
+            if (Dense_) {
+                for (std::size_t row = 0; row < Size_; ++row) {
+                    Selection_[selected] = row;
+                    selected += bool(condition(row));
+                }
+            } else {
+                for (std::size_t i = 0; i < Selected_; ++i) {
+                    const std::size_t row = Selection_[i];
+                    Selection_[selected] = row;
+                    selected += bool(condition(row));
+                }
+            }
+            Selected_ = selected;
+            Dense_ = false;
+        }
+
+        void CopyRowsFrom(const TBlockRows& other) {
+            Size_ = other.Size_;
+            Selected_ = other.Selected_;
+            Dense_ = other.Dense_;
+            if (!Dense_) {
+                std::copy_n(other.Selection_.begin(), Selected_, Selection_.begin());
+            }
+        }
+    };
+
+    //! References are kept as pointers, values that cannot be assigned as std::optional
+    template <typename TValue>
+    using TBlockSlot = std::conditional_t<std::is_reference_v<TValue>, std::remove_reference_t<TValue>*,
+        std::conditional_t<std::is_default_constructible_v<TValue> && std::is_move_assignable_v<TValue>,
+            TValue, std::optional<TValue>>>;
+
+    template <typename TDerived>
+    struct TBlockBase : TBlockRows {
+        //! Calls fn(x) for every selected row
+        template <typename TFunction>
+        void ForEach(TFunction&& fn) const {
+            ForEachRow([this, &fn](std::size_t row) {
+                fn(static_cast<const TDerived&>(*this)[row]);
+            });
+        }
+    };
+
+    //! Column of up to BlockSize values of type TValue
+    template <typename TValue>
+    struct TBlock : TBlockBase<TBlock<TValue>> {
+        using TSlot = TBlockSlot<TValue>;
+
+        //! Slots are contiguous, so for arithmetic values a consumer can run a plain loop over them
+        std::array<TSlot, BlockSize> Slots_;
+
+        template <typename TFrom>
+        void Store(std::size_t row, TFrom&& value) {
+            if constexpr (std::is_reference_v<TValue>) {
+                Slots_[row] = std::addressof(value);
+            } else if constexpr (std::is_same_v<TSlot, TValue>) {
+                Slots_[row] = std::forward<TFrom>(value);
+            } else {
+                Slots_[row].emplace(std::forward<TFrom>(value));
+            }
+        }
+
+        template <typename TFrom>
+        void Push(TFrom&& value) {
+            Store(this->Size_++, std::forward<TFrom>(value));
+        }
+
+        decltype(auto) operator[](std::size_t row) const {
+            if constexpr (std::is_reference_v<TValue>) {
+                return static_cast<TValue>(*Slots_[row]);
+            } else if constexpr (std::is_same_v<TSlot, TValue>) {
+                return Slots_[row];
+            } else {
+                return *Slots_[row];
+            }
+        }
+    };
+
+    //! Block of Zip: a block per container, rows are the same in all of them
+    template <typename TValue, typename... TColumns>
+    struct TZipBlock : TBlockBase<TZipBlock<TValue, TColumns...>> {
+        std::tuple<TColumns...> Columns_;
+
+        TValue operator[](std::size_t row) const {
+            return std::apply([row](const auto&... column) {
+                return TValue{column[row]...};
+            }, Columns_);
+        }
+    };
+
+    //! Reads any container by its iterators
+    template <typename TIterator, typename TSentinel>
+    struct TIteratorBlockReader {
+        using TBlockType = TBlock<decltype(*std::declval<TIterator&>())>;
+        static constexpr bool Dense = true;
+
+        TIterator Begin_;
+        TSentinel End_;
+
+        //! Appends rows until the block is full, returns false when the input is exhausted
+        bool Fill(TBlockType& block) {
+            if constexpr (std::is_same_v<TIterator, TSentinel> &&
+                          std::is_same_v<typename std::iterator_traits<TIterator>::iterator_category, std::random_access_iterator_tag>) {
+                const std::size_t count = std::min<std::size_t>(BlockSize - block.Size_, End_ - Begin_);
+                for (std::size_t i = 0; i < count; ++i, ++Begin_) {
+                    block.Push(*Begin_);
+                }
+            } else {
+                for (; !block.Full() && Begin_ != End_; ++Begin_) {
+                    block.Push(*Begin_);
+                }
+            }
+            return Begin_ != End_;
+        }
+    };
+
+    template <typename TInputReader, typename TCondition>
+    struct TFilterBlockReader {
+        using TBlockType = typename TInputReader::TBlockType;
+        static constexpr bool Dense = false;
+
+        TInputReader Input_;
+        TCondition* Condition_;
+
+        //! Block must be empty, it is refilled until some row is accepted
+        bool Fill(TBlockType& block) {
+            bool notExhausted = true;
+            do {
+                block.Clear();
+                notExhausted = Input_.Fill(block);
+                block.Select([this, &block](std::size_t row) {
+                    return (*Condition_)(block[row]);
+                });
+            } while (notExhausted && block.Selected_ == 0);
+            return notExhausted;
+        }
+    };
+
+    template <typename TInputReader, typename TMapper>
+    struct TMapBlockReader {
+        using TInputBlock = typename TInputReader::TBlockType;
+        using TBlockType = TBlock<decltype(std::declval<TMapper&>()(std::declval<const TInputBlock&>()[0]))>;
+        static constexpr bool Dense = TInputReader::Dense;
+
+        TInputReader Input_;
+        TMapper* Mapper_;
+        TInputBlock InputBlock_;
+
+        bool Fill(TBlockType& block) {
+            // input rows are placed at the same positions, so the block may be partly filled already
+            const std::size_t start = block.Size_;
+            InputBlock_.Clear();
+            InputBlock_.Size_ = start;
+            const bool notExhausted = Input_.Fill(InputBlock_);
+            if constexpr (Dense) {
+                for (std::size_t row = start; row < InputBlock_.Size_; ++row) {
+                    block.Store(row, (*Mapper_)(InputBlock_[row]));
+                }
+                block.Size_ = InputBlock_.Size_;
+            } else {
+                block.CopyRowsFrom(InputBlock_);
+                InputBlock_.ForEachRow([this, &block](std::size_t row) {
+                    block.Store(row, (*Mapper_)(InputBlock_[row]));
+                });
+            }
+            return notExhausted;
+        }
+    };
+
+    //! All inputs must be dense: every column is filled up to the same row, the shortest one ends the Zip
+    template <typename TValue, typename... TInputReaders>
+    struct TZipBlockReader {
+        using TBlockType = TZipBlock<TValue, typename TInputReaders::TBlockType...>;
+        static constexpr bool Dense = true;
+
+        std::tuple<TInputReaders...> Inputs_;
+
+        bool Fill(TBlockType& block) {
+            return FillColumns(block, std::index_sequence_for<TInputReaders...>{});
+        }
+
+    private:
+        template <std::size_t... I>
+        bool FillColumns(TBlockType& block, std::index_sequence<I...>) {
+            const std::size_t start = block.Size_;
+            auto fillColumn = [start](auto& input, auto& column) {
+                column.Clear();
+                column.Size_ = start;
+                return input.Fill(column);
+            };
+            const bool notExhausted = (fillColumn(std::get<I>(Inputs_), std::get<I>(block.Columns_)) & ...);
+            block.Size_ = std::min({std::get<I>(block.Columns_).Size_...});
+            return notExhausted;
+        }
+    };
+
+    //! All inputs must be dense and have the same block type
+    template <typename... TInputReaders>
+    struct TConcatenateBlockReader {
+        using TBlockType = typename std::tuple_element_t<0, std::tuple<TInputReaders...>>::TBlockType;
+        static constexpr bool Dense = true;
+
+        std::tuple<TInputReaders...> Inputs_;
+        std::size_t Position_ = 0;
+
+        bool Fill(TBlockType& block) {
+            return FillFrom<0>(block);
+        }
+
+    private:
+        template <std::size_t index>
+        bool FillFrom(TBlockType& block) {
+            if (Position_ == index) {
+                if (std::get<index>(Inputs_).Fill(block)) {
+                    return true;
+                }
+                ++Position_;
+            }
+            if constexpr (index + 1 < sizeof...(TInputReaders)) {
+                return FillFrom<index + 1>(block);
+            } else {
+                return false;
+            }
+        }
+    };
+
+    template <typename TContainer>
+    static constexpr bool HasBlockReader(int32_t, decltype(std::declval<TContainer&>().BlockReader())*) {
+        return true;
+    }
+
+    template <typename TContainer>
+    static constexpr bool HasBlockReader(char, std::nullptr_t*) {
+        return false;
+    }
+
+    template <typename TContainer>
+    auto IteratorBlockReader(TContainer& container) {
+        return TIteratorBlockReader<decltype(std::begin(container)), decltype(std::end(container))>{
+            std::begin(container), std::end(container)};
+    }
+
+}
+
+//! Reader of the container by blocks, the container must outlive it
+//! Usage: auto reader = BlockReader(c); decltype(reader)::TBlockType block; do { block.Clear(); more = reader.Fill(block); ... } while (more);
+template <typename TContainer>
+auto BlockReader(TContainer& container) {
+    if constexpr (NPrivate::HasBlockReader<TContainer>((int32_t)0, nullptr)) {
+        return container.BlockReader();
+    } else {
+        return NPrivate::IteratorBlockReader(container);
+    }
+}
+
+//! Calls fn(block) for every block with selected rows, rows are visited by block.ForEach(fn)
+//! Usage: ForEachBlock(Filter(p, Map(f, a)), [&](const auto& block) { block.ForEach([&](auto x) {...}); });
+template <typename TContainerOrRef, typename TFunction>
+void ForEachBlock(TContainerOrRef&& container, TFunction&& fn) {
+    auto reader = ::BlockReader(container);
+    typename decltype(reader)::TBlockType block;
+    for (bool notExhausted = true; notExhausted;) {
+        block.Clear();
+        notExhausted = reader.Fill(block);
+        if (block.SelectedCount()) {
+            fn(std::as_const(block));
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+
+/** @file
+ * Evaluation of a predicate over a block of contiguous elements into a bitmask.
+ * Predicate is called for every element of the block without branches, so compiler vectorizes the loop,
+ * then set bits are walked with count-trailing-zeros. It is much better than a data-dependent branch
+ * per element when selectivity is close to 50%.
+ * Mask loop is compiled for several instruction sets and one of them is chosen at runtime.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FUNCTOOLS_BLOCK_MASK_DISPATCH
+#define FUNCTOOLS_FORCE_INLINE inline __attribute__((always_inline))
+#else
+#define FUNCTOOLS_FORCE_INLINE inline
+#endif
+
+namespace NPrivate {
+
+    enum class ESimdLevel {
+        Default,  // SSE2 on x86_64
+        Avx2,
+        Avx512,
+    };
+
+    inline ESimdLevel DetectSimdLevel() {
+#ifdef FUNCTOOLS_BLOCK_MASK_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return ESimdLevel::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return ESimdLevel::Avx2;
+        }
+#endif
+        return ESimdLevel::Default;
+    }
+
+    //! Detected once at startup, so there is no initialization guard on the hot path
+    inline const ESimdLevel SimdLevel = DetectSimdLevel();
+
+    using TBlockMask = uint64_t;
+    static constexpr std::ptrdiff_t BlockMaskSize = 64;
+
+    template <typename TElement, typename TCondition>
+    FUNCTOOLS_FORCE_INLINE constexpr TBlockMask CalcBlockMaskImpl(TElement* block, std::ptrdiff_t size, TCondition& condition) {
+        TBlockMask mask = 0;
+        if (size == BlockMaskSize) {
+            // constant trip count for full blocks
+            for (std::ptrdiff_t j = 0; j < BlockMaskSize; ++j) {
+                mask |= TBlockMask(bool(condition(block[j]))) << j;
+            }
+        } else {
+            for (std::ptrdiff_t j = 0; j < size; ++j) {
+                mask |= TBlockMask(bool(condition(block[j]))) << j;
+            }
+        }
+        return mask;
+    }
+
+#ifdef FUNCTOOLS_BLOCK_MASK_DISPATCH
+    template <typename TElement, typename TCondition>
+    __attribute__((target("avx2"))) TBlockMask CalcBlockMaskAvx2(TElement* block, std::ptrdiff_t size, TCondition& condition) {
+        return CalcBlockMaskImpl(block, size, condition);
+    }
+
+    template <typename TElement, typename TCondition>
+    __attribute__((target("avx512f,avx512bw"))) TBlockMask CalcBlockMaskAvx512(TElement* block, std::ptrdiff_t size, TCondition& condition) {
+        return CalcBlockMaskImpl(block, size, condition);
+    }
+#endif
+
+    //! Bit j of result is condition(block[j]), size <= BlockMaskSize.
+    //! In constant evaluation (e.g. Filter over a constexpr array) the portable loop is used
+    template <typename TElement, typename TCondition>
+    constexpr TBlockMask CalcBlockMask(TElement* block, std::ptrdiff_t size, TCondition& condition) {
+#ifdef FUNCTOOLS_BLOCK_MASK_DISPATCH
+        if (__builtin_is_constant_evaluated()) {
+            return CalcBlockMaskImpl(block, size, condition);
+        }
+        switch (SimdLevel) {
+            case ESimdLevel::Avx512:
+                return CalcBlockMaskAvx512(block, size, condition);
+            case ESimdLevel::Avx2:
+                return CalcBlockMaskAvx2(block, size, condition);
+            default:
+                break;
+        }
+#endif
+        return CalcBlockMaskImpl(block, size, condition);
+    }
+
+    //! mask must not be zero
+    constexpr std::ptrdiff_t LowestBit(TBlockMask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(mask);
+#else
+        std::ptrdiff_t bit = 0;
+        for (; !(mask & 1); mask >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    //! mask must not be zero
+    constexpr std::ptrdiff_t HighestBit(TBlockMask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return BlockMaskSize - 1 - __builtin_clzll(mask);
+#else
+        std::ptrdiff_t bit = 0;
+        for (; mask >>= 1;) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    constexpr std::ptrdiff_t PopCount(TBlockMask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(mask);
+#else
+        std::ptrdiff_t count = 0;
+        for (; mask; mask &= mask - 1) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    template <typename TContainer>
+    static constexpr bool HasArithmeticData(int32_t, decltype(std::data(std::declval<TContainer&>()))*) {
+        using TData = decltype(std::data(std::declval<TContainer&>()));
+        return std::is_pointer_v<TData> && std::is_arithmetic_v<std::remove_pointer_t<TData>> &&
+            std::is_same_v<decltype(*std::begin(std::declval<TContainer&>())), std::remove_pointer_t<TData>&>;
+    }
+
+    template <typename TContainer>
+    static constexpr bool HasArithmeticData(char, std::nullptr_t*) {
+        return false;
+    }
+
+}
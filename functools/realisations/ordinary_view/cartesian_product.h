@@ -1,7 +1,14 @@
 #pragma once
 
+#include "for_each.h"
+#include "light_tuple.h"
+#include "size_hint.h"
+#include "static_extent.h"
+#include "traits.h"
+
 #include <util/generic/store_policy.h>
 
+#include <array>
 #include <iterator>
 #include <tuple>
 
@@ -13,88 +20,274 @@ namespace NPrivate {
         template <std::size_t... I>
         struct TCartesianMultiplierWithIndex {
         private:
-            using THolders = std::tuple<TAutoEmbedOrPtrPolicy<TContainers>...>;
+            using THolders = TLightTuple<TAutoEmbedOrPtrPolicy<TContainers>...>;
             using TValue = std::tuple<decltype(*std::begin(std::declval<TContainers&>()))...>;
-            using TIteratorState = std::tuple<int, decltype(std::begin(std::declval<TContainers&>()))...>;
-            using TSentinelState = std::tuple<int, decltype(std::end(std::declval<TContainers&>()))...>;
+            using TIteratorState = TLightTuple<int, decltype(std::begin(std::declval<TContainers&>()))...>;
+            using TSentinelState = TLightTuple<int, decltype(std::end(std::declval<TContainers&>()))...>;
+            using TBegins = TLightTuple<decltype(std::begin(std::declval<TContainers&>()))...>;
+            using TDigits = std::array<std::ptrdiff_t, sizeof...(TContainers)>;
+
+            static constexpr bool TrivialSentinel = std::is_same_v<TIteratorState, TSentinelState>;
+
+        public:
+            //! Iterator keeps linear position in the product and its mixed-radix digits (indexes in containers)
+            static constexpr bool RandomAccess = TrivialSentinel && (HasRandomAccessIterator<TContainers>(0) && ...);
 
-            struct TIterator;
+            //! Number of tuples is known before iteration
+            static constexpr bool Sized = RandomAccess || (HasSize<TContainers>(0) && ...);
+
+            //! Product of the inputs if all of them are known at compile time
+            static constexpr std::size_t Extent = ProductExtent<TContainers...>();
+
+        private:
+            struct TInputIterator;
+            struct TRandomAccessIterator;
+            using TIterator = std::conditional_t<RandomAccess, TRandomAccessIterator, TInputIterator>;
             struct TSentinelCandidate {
                 TSentinelState Iterators_;
-                THolders* HoldersPtr_;
+                const THolders* HoldersPtr_;
             };
-            using TSentinel = std::conditional_t<std::is_same_v<TIteratorState, TSentinelState>,
-                                                 TIterator, TSentinelCandidate>;
+            using TSentinel = std::conditional_t<TrivialSentinel, TIterator, TSentinelCandidate>;
+
+            struct TRandomAccessIterator {
+                using difference_type = std::ptrdiff_t;
+                using value_type = std::decay_t<TValue>;
+                using pointer = TValue*;
+                using reference = TValue;
+                using iterator_category = std::random_access_iterator_tag;
 
-            struct TIterator {
+                constexpr TValue operator*() const {
+                    return {*(Get<I>(Begins_) + Digits_[I])...};
+                }
+                constexpr TValue operator[](difference_type n) const {
+                    return *(*this + n);
+                }
+                constexpr TRandomAccessIterator& operator++() {
+                    ++Position_;
+                    // odometer, the last container changes fastest
+                    for (std::size_t k = sizeof...(TContainers); k-- > 0;) {
+                        if (++Digits_[k] < Sizes_[k] || k == 0) {
+                            break;
+                        }
+                        Digits_[k] = 0;
+                    }
+                    return *this;
+                }
+                constexpr TRandomAccessIterator operator++(int) {
+                    TRandomAccessIterator result = *this;
+                    ++*this;
+                    return result;
+                }
+                constexpr TRandomAccessIterator& operator--() {
+                    --Position_;
+                    for (std::size_t k = sizeof...(TContainers); k-- > 0;) {
+                        if (Digits_[k]-- > 0 || k == 0) {
+                            break;
+                        }
+                        Digits_[k] = Sizes_[k] - 1;
+                    }
+                    return *this;
+                }
+                constexpr TRandomAccessIterator operator--(int) {
+                    TRandomAccessIterator result = *this;
+                    --*this;
+                    return result;
+                }
+                constexpr TRandomAccessIterator& operator+=(difference_type n) {
+                    Position_ += n;
+                    Decompose();
+                    return *this;
+                }
+                constexpr TRandomAccessIterator& operator-=(difference_type n) {
+                    return *this += -n;
+                }
+                constexpr TRandomAccessIterator operator+(difference_type n) const {
+                    TRandomAccessIterator result = *this;
+                    return result += n;
+                }
+                friend constexpr TRandomAccessIterator operator+(difference_type n, const TRandomAccessIterator& iterator) {
+                    return iterator + n;
+                }
+                constexpr TRandomAccessIterator operator-(difference_type n) const {
+                    TRandomAccessIterator result = *this;
+                    return result -= n;
+                }
+                constexpr difference_type operator-(const TRandomAccessIterator& other) const {
+                    return Position_ - other.Position_;
+                }
+                constexpr bool operator!=(const TRandomAccessIterator& other) const {
+                    return Position_ != other.Position_;
+                }
+                constexpr bool operator==(const TRandomAccessIterator& other) const {
+                    return Position_ == other.Position_;
+                }
+                constexpr bool operator<(const TRandomAccessIterator& other) const {
+                    return Position_ < other.Position_;
+                }
+                constexpr bool operator>(const TRandomAccessIterator& other) const {
+                    return Position_ > other.Position_;
+                }
+                constexpr bool operator<=(const TRandomAccessIterator& other) const {
+                    return Position_ <= other.Position_;
+                }
+                constexpr bool operator>=(const TRandomAccessIterator& other) const {
+                    return Position_ >= other.Position_;
+                }
+
+                //! Mixed-radix decomposition of Position_, the first digit is not bounded, so end() is {size0, 0, ..., 0}
+                constexpr void Decompose() {
+                    auto rest = Position_;
+                    for (std::size_t k = sizeof...(TContainers); k-- > 1;) {
+                        if (!Sizes_[k]) {
+                            // empty product, the only valid position is 0
+                            Digits_ = {};
+                            return;
+                        }
+                        Digits_[k] = rest % Sizes_[k];
+                        rest /= Sizes_[k];
+                    }
+                    Digits_[0] = rest;
+                }
+
+                TBegins Begins_;
+                TDigits Sizes_;
+                TDigits Digits_;
+                difference_type Position_;
+            };
+
+            struct TInputIterator {
             private:
                 //! Return value is true when iteration is not finished
                 template <std::size_t position = sizeof...(TContainers)>
-                void IncrementIteratorsTuple() {
-                    auto& currentIterator = std::get<position>(Iterators_);
+                constexpr void IncrementIteratorsTuple() {
+                    auto& currentIterator = Get<position>(Iterators_);
                     ++currentIterator;
 
-                    if (currentIterator != std::end(*std::get<position - 1>(*HoldersPtr_).Ptr())) {
+                    if (currentIterator != std::end(*Get<position - 1>(*HoldersPtr_).Ptr())) {
                         return;
                     } else {
-                        currentIterator = std::begin(*std::get<position - 1>(*HoldersPtr_).Ptr());
+                        currentIterator = std::begin(*Get<position - 1>(*HoldersPtr_).Ptr());
                         if constexpr (position != 1) {
                             IncrementIteratorsTuple<position - 1>();
                         } else {
-                            std::get<0>(Iterators_) = 1;
+                            Get<0>(Iterators_) = 1;
                         }
                     }
                 }
             public:
                 using difference_type = std::ptrdiff_t;
-                using value_type = TValue;
+                using value_type = std::decay_t<TValue>;
                 using pointer = TValue*;
                 using reference = TValue&;
                 using iterator_category = std::input_iterator_tag;
 
-                TValue operator*() {
-                    return {*std::get<I + 1>(Iterators_)...};
+                constexpr TValue operator*() {
+                    return {*Get<I + 1>(Iterators_)...};
                 }
-                void operator++() {
+                constexpr void operator++() {
                     IncrementIteratorsTuple();
                 }
-                bool operator!=(const TSentinel& other) const {
+                constexpr bool operator!=(const TSentinel& other) const {
                     // not finished iterator VS sentinel (most frequent case)
-                    if (std::get<0>(Iterators_) != std::get<0>(other.Iterators_)) {
+                    if (Get<0>(Iterators_) != Get<0>(other.Iterators_)) {
                         return true;
                     }
                     // do not compare sentinels and finished iterators
-                    if (std::get<0>(other.Iterators_)) {
+                    if (Get<0>(other.Iterators_)) {
                         return false;
                     }
                     // compare not finished iterators
-                    return ((std::get<I + 1>(Iterators_) != std::get<I + 1>(other.Iterators_)) || ...);
+                    return ((Get<I + 1>(Iterators_) != Get<I + 1>(other.Iterators_)) || ...);
                 }
-                bool operator==(const TSentinel& other) const {
+                constexpr bool operator==(const TSentinel& other) const {
                     return !(*this != other);
                 }
 
                 TIteratorState Iterators_;
-                THolders* HoldersPtr_;
+                const THolders* HoldersPtr_;
             };
+
+            constexpr TDigits Sizes() const {
+                return {std::ptrdiff_t(std::end(*Get<I>(Holders_).Ptr()) - std::begin(*Get<I>(Holders_).Ptr()))...};
+            }
+
+            constexpr TRandomAccessIterator MakeRandomAccessIterator(std::ptrdiff_t position) const {
+                TRandomAccessIterator iterator{TBegins{std::begin(*Get<I>(Holders_).Ptr())...}, Sizes(), {}, position};
+                iterator.Decompose();
+                return iterator;
+            }
+
         public:
             using iterator = TIterator;
             using const_iterator = TIterator;
+            using size_type = std::size_t;
+
+            constexpr TIterator begin() const {
+                if constexpr (RandomAccess) {
+                    return MakeRandomAccessIterator(0);
+                } else {
+                    bool isEmpty = !((std::begin(*Get<I>(Holders_).Ptr()) != std::end(*Get<I>(Holders_).Ptr())) && ...);
+                    return {TIteratorState{int(isEmpty), std::begin(*Get<I>(Holders_).Ptr())...}, &Holders_};
+                }
+            }
+
+            constexpr TSentinel end() const {
+                if constexpr (RandomAccess) {
+                    return MakeRandomAccessIterator(size());
+                } else {
+                    return {TSentinelState{1, std::end(*Get<I>(Holders_).Ptr())...}, &Holders_};
+                }
+            }
 
-            TIterator begin() const {
-                bool isEmpty = !((std::begin(*std::get<I>(Holders_).Ptr()) != std::end(*std::get<I>(Holders_).Ptr())) && ...);
-                return {TIteratorState{int(isEmpty), std::begin(*std::get<I>(Holders_).Ptr())...}, &Holders_};
+            //! Product of sizes of the containers, declared only for sized containers so HasSize of outer adaptors is not misled
+            template <bool S = Sized, std::enable_if_t<S, int> = 0>
+            constexpr size_type size() const {
+                if constexpr (Extent != DynamicExtent) {
+                    return Extent;
+                } else if constexpr (RandomAccess) {
+                    return (size_type(std::end(*Get<I>(Holders_).Ptr()) - std::begin(*Get<I>(Holders_).Ptr())) * ...);
+                } else {
+                    return (size_type(std::size(*Get<I>(Holders_).Ptr())) * ...);
+                }
+            }
+
+            constexpr bool empty() const {
+                return !((std::begin(*Get<I>(Holders_).Ptr()) != std::end(*Get<I>(Holders_).Ptr())) && ...);
             }
 
-            TSentinel end() const {
-                return {TSentinelState{1, std::end(*std::get<I>(Holders_).Ptr())...}, &Holders_};
+            //! The n-th tuple in lexicographic order, O(number of containers)
+            template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+            constexpr TValue operator[](size_type at) const {
+                return *MakeRandomAccessIterator(at);
             }
 
-            mutable THolders Holders_;
+            TSizeHint SizeHint() const {
+                return (::SizeHint(*Get<I>(Holders_).Ptr()) * ...);
+            }
+
+            template <typename TFunction>
+            void ForEach(TFunction&& fn) const {
+                ForEachNested(fn);
+            }
+
+            THolders Holders_;
+
+        private:
+            //! Real nested loops: the outer values are passed down as lvalues, so they are never moved from
+            template <std::size_t position = 0, typename TFunction, typename... TOuterValues>
+            void ForEachNested(TFunction& fn, TOuterValues&... values) const {
+                if constexpr (position == sizeof...(TContainers)) {
+                    fn(TValue{values...});
+                } else {
+                    ::ForEach(*Get<position>(Holders_).Ptr(), [&](auto&& x) {
+                        ForEachNested<position + 1>(fn, values..., x);
+                    });
+                }
+            }
         };
 
         template <std::size_t... I>
-        static auto CartesianMultiply(TContainers&&... containers, std::index_sequence<I...>) {
+        static constexpr auto CartesianMultiply(TContainers&&... containers, std::index_sequence<I...>) {
             return TCartesianMultiplierWithIndex<I...>{{std::forward<TContainers>(containers)...}};
         }
     };
@@ -104,7 +297,7 @@ namespace NPrivate {
 //! Usage: for (auto [ai, bi] : CartesianProduct(a, b)) {...}
 //! Equivalent: for (auto& ai : a) { for (auto& bi : b) {...} }
 template <typename... TContainers>
-auto CartesianProduct(TContainers&&... containers) {
+constexpr auto CartesianProduct(TContainers&&... containers) {
     return NPrivate::TCartesianMultiplier<TContainers...>::CartesianMultiply(
         std::forward<TContainers>(containers)..., std::make_index_sequence<sizeof...(TContainers)>{});
 }
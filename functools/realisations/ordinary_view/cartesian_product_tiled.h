@@ -0,0 +1,190 @@
+#pragma once
+
+#include "size_hint.h"
+#include "traits.h"
+
+#include <util/generic/store_policy.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+
+/** @file
+ * Cartesian product of two random access containers visited tile by tile:
+ * for every pair of tiles (tileA elements of the first container, tileB elements of the second)
+ * all their pairs are visited before moving on, so both tiles stay in cache.
+ * Lexicographic order streams the whole second container once per element of the first one instead.
+ * Every pair is visited exactly once, but the order is not lexicographic.
+ * Runtime only: the containers are held in mutable storages.
+ */
+
+namespace NPrivate {
+
+    //! Size of L2 data cache in bytes, assumed 256KiB when the system does not tell
+    inline std::size_t QueryL2CacheSize() {
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+        long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (size > 0) {
+            return size;
+        }
+#endif
+        return 256 * 1024;
+    }
+
+    inline const std::size_t L2CacheSize = QueryL2CacheSize();
+
+    //! Half of L2 for both tiles, the rest is left for everything the loop body touches
+    inline std::size_t DefaultTileSize(std::size_t elementSize) {
+        std::size_t budget = L2CacheSize / 4;
+        return std::max<std::size_t>(1, budget / std::max<std::size_t>(1, elementSize));
+    }
+
+    template <typename TContainerA, typename TContainerB>
+    struct TTiledCartesianMultiplier {
+    private:
+        using TStorageA = TAutoEmbedOrPtrPolicy<TContainerA>;
+        using TStorageB = TAutoEmbedOrPtrPolicy<TContainerB>;
+        using TIteratorStateA = decltype(std::begin(std::declval<TContainerA&>()));
+        using TIteratorStateB = decltype(std::begin(std::declval<TContainerB&>()));
+        using TValue = std::tuple<decltype(*std::declval<TIteratorStateA&>()), decltype(*std::declval<TIteratorStateB&>())>;
+
+        static_assert(HasRandomAccessIterator<TContainerA>(0) && HasRandomAccessIterator<TContainerB>(0),
+            "CartesianProductTiled requires random access containers");
+        static_assert(std::is_same_v<TIteratorStateA, decltype(std::end(std::declval<TContainerA&>()))> &&
+            std::is_same_v<TIteratorStateB, decltype(std::end(std::declval<TContainerB&>()))>,
+            "CartesianProductTiled requires containers with begin and end of the same type");
+
+        struct TIterator {
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::decay_t<TValue>;
+            using pointer = TValue*;
+            using reference = TValue;
+            using iterator_category = std::input_iterator_tag;
+
+            TValue operator*() const {
+                return {*(BeginA_ + IndexA_), *(BeginB_ + IndexB_)};
+            }
+            TIterator& operator++() {
+                ++Position_;
+                if (++IndexB_ < std::min(TileStartB_ + TileB_, SizeB_)) {
+                    return *this;
+                }
+                IndexB_ = TileStartB_;
+                if (++IndexA_ < std::min(TileStartA_ + TileA_, SizeA_)) {
+                    return *this;
+                }
+                // next pair of tiles, the second container changes faster
+                TileStartB_ += TileB_;
+                if (TileStartB_ >= SizeB_) {
+                    TileStartB_ = 0;
+                    TileStartA_ += TileA_;
+                }
+                IndexA_ = TileStartA_;
+                IndexB_ = TileStartB_;
+                return *this;
+            }
+            bool operator!=(const TIterator& other) const {
+                return Position_ != other.Position_;
+            }
+            bool operator==(const TIterator& other) const {
+                return Position_ == other.Position_;
+            }
+
+            TIteratorStateA BeginA_;
+            TIteratorStateB BeginB_;
+            std::ptrdiff_t SizeA_;
+            std::ptrdiff_t SizeB_;
+            std::ptrdiff_t TileA_;
+            std::ptrdiff_t TileB_;
+            std::ptrdiff_t TileStartA_ = 0;
+            std::ptrdiff_t TileStartB_ = 0;
+            std::ptrdiff_t IndexA_ = 0;
+            std::ptrdiff_t IndexB_ = 0;
+            //! Number of visited pairs, iterators are compared by it only
+            std::ptrdiff_t Position_ = 0;
+        };
+
+        std::ptrdiff_t SizeA() const {
+            return std::end(*StorageA_.Ptr()) - std::begin(*StorageA_.Ptr());
+        }
+
+        std::ptrdiff_t SizeB() const {
+            return std::end(*StorageB_.Ptr()) - std::begin(*StorageB_.Ptr());
+        }
+
+    public:
+        using iterator = TIterator;
+        using const_iterator = TIterator;
+        using size_type = std::size_t;
+
+        TIterator begin() const {
+            return {std::begin(*StorageA_.Ptr()), std::begin(*StorageB_.Ptr()), SizeA(), SizeB(), TileA_, TileB_};
+        }
+
+        TIterator end() const {
+            TIterator result = begin();
+            result.Position_ = size();
+            return result;
+        }
+
+        size_type size() const {
+            return size_type(SizeA()) * size_type(SizeB());
+        }
+
+        bool empty() const {
+            return !size();
+        }
+
+        TSizeHint SizeHint() const {
+            return {ESizeHint::Exact, size()};
+        }
+
+        template <typename TFunction>
+        void ForEach(TFunction&& fn) const {
+            const auto beginA = std::begin(*StorageA_.Ptr());
+            const auto beginB = std::begin(*StorageB_.Ptr());
+            const std::ptrdiff_t sizeA = SizeA();
+            const std::ptrdiff_t sizeB = SizeB();
+            for (std::ptrdiff_t tileStartA = 0; tileStartA < sizeA; tileStartA += TileA_) {
+                const std::ptrdiff_t tileEndA = std::min(tileStartA + TileA_, sizeA);
+                for (std::ptrdiff_t tileStartB = 0; tileStartB < sizeB; tileStartB += TileB_) {
+                    const std::ptrdiff_t tileEndB = std::min(tileStartB + TileB_, sizeB);
+                    for (std::ptrdiff_t j = tileStartA; j < tileEndA; ++j) {
+                        auto&& x = *(beginA + j);
+                        for (std::ptrdiff_t k = tileStartB; k < tileEndB; ++k) {
+                            fn(TValue{x, *(beginB + k)});
+                        }
+                    }
+                }
+            }
+        }
+
+        mutable TStorageA StorageA_;
+        mutable TStorageB StorageB_;
+        std::ptrdiff_t TileA_;
+        std::ptrdiff_t TileB_;
+    };
+
+}
+
+//! Visits every pair of CartesianProduct(a, b) once, tile by tile, for big containers that do not fit in cache
+//! Zero tile size means default: tiles of both containers take half of L2 together
+//! Usage: ForEach(CartesianProductTiled(a, b), [&](auto t) { auto [ai, bi] = t; ... });
+//!        for (auto [ai, bi] : CartesianProductTiled(a, b, 256, 1024)) {...}
+template <typename TContainerA, typename TContainerB>
+auto CartesianProductTiled(TContainerA&& a, TContainerB&& b, std::size_t tileA = 0, std::size_t tileB = 0) {
+    if (!tileA) {
+        tileA = NPrivate::DefaultTileSize(sizeof(*std::begin(a)));
+    }
+    if (!tileB) {
+        tileB = NPrivate::DefaultTileSize(sizeof(*std::begin(b)));
+    }
+    return NPrivate::TTiledCartesianMultiplier<TContainerA, TContainerB>{
+        std::forward<TContainerA>(a), std::forward<TContainerB>(b), std::ptrdiff_t(tileA), std::ptrdiff_t(tileB)};
+}
@@ -0,0 +1,338 @@
+#pragma once
+
+#include "for_each.h"
+#include "size_hint.h"
+#include "traits.h"
+
+#include <util/generic/iterator_range.h>
+#include <util/generic/store_policy.h>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+
+/** @file
+ * Splitting of a range into batches.
+ * Chunks of random access containers are subranges, nothing is copied.
+ * Elements of other ranges (Filter, Concatenate, ...) are collected into a buffer owned by the iterator,
+ * so such chunks are single pass: a chunk is valid until its iterator is incremented or destroyed.
+ * Chunks<N> yields std::array<T, N>, so the loop over a chunk has constant trip count and may be unrolled.
+ * It yields only full chunks, the incomplete last one is available by Remainder() (after iteration for buffered ranges).
+ * The remainder is mutable state of the range, so Chunks is not usable in constant expressions.
+ */
+
+namespace NPrivate {
+
+    //! StaticSize is 0 when size of chunks is known at runtime only
+    template <typename TContainer, std::size_t StaticSize>
+    struct TChunker {
+    private:
+        using TStorage = TAutoEmbedOrPtrPolicy<TContainer>;
+        using TIteratorState = decltype(std::begin(std::declval<TContainer&>()));
+        using TSentinelState = decltype(std::end(std::declval<TContainer&>()));
+        using TElement = std::decay_t<decltype(*std::declval<TIteratorState&>())>;
+
+        static constexpr bool TrivialSentinel = std::is_same_v<TIteratorState, TSentinelState>;
+
+    public:
+        //! Chunks are subranges of the container and iterator is random access
+        static constexpr bool RandomAccess = TrivialSentinel && HasRandomAccessIterator<TContainer>(0);
+
+    private:
+        using TBuffer = std::conditional_t<StaticSize != 0, std::array<TElement, StaticSize>, std::vector<TElement>>;
+        using TArray = std::array<TElement, StaticSize>;
+        using TValue = std::conditional_t<StaticSize != 0,
+            std::conditional_t<RandomAccess, TArray, const TArray&>,
+            std::conditional_t<RandomAccess, TIteratorRange<TIteratorState>, TIteratorRange<TElement*>>>;
+
+        template <std::size_t... J>
+        static TArray MakeArray(const TIteratorState& first, std::index_sequence<J...>) {
+            return {*(first + J)...};
+        }
+
+        struct TRandomAccessIterator {
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::decay_t<TValue>;
+            using pointer = value_type*;
+            using reference = TValue;
+            using iterator_category = std::random_access_iterator_tag;
+
+            TValue operator*() const {
+                if constexpr (StaticSize != 0) {
+                    return MakeArray(Begin_ + Position_, std::make_index_sequence<StaticSize>{});
+                } else {
+                    return {Begin_ + Position_, Begin_ + std::min(Position_ + Step_, Size_)};
+                }
+            }
+            TValue operator[](difference_type n) const {
+                return *(*this + n);
+            }
+            TRandomAccessIterator& operator++() {
+                Position_ += Step_;
+                return *this;
+            }
+            TRandomAccessIterator operator++(int) {
+                TRandomAccessIterator result = *this;
+                Position_ += Step_;
+                return result;
+            }
+            TRandomAccessIterator& operator--() {
+                Position_ -= Step_;
+                return *this;
+            }
+            TRandomAccessIterator operator--(int) {
+                TRandomAccessIterator result = *this;
+                Position_ -= Step_;
+                return result;
+            }
+            TRandomAccessIterator& operator+=(difference_type n) {
+                Position_ += n * Step_;
+                return *this;
+            }
+            TRandomAccessIterator& operator-=(difference_type n) {
+                Position_ -= n * Step_;
+                return *this;
+            }
+            TRandomAccessIterator operator+(difference_type n) const {
+                TRandomAccessIterator result = *this;
+                return result += n;
+            }
+            friend TRandomAccessIterator operator+(difference_type n, const TRandomAccessIterator& iterator) {
+                return iterator + n;
+            }
+            TRandomAccessIterator operator-(difference_type n) const {
+                TRandomAccessIterator result = *this;
+                return result -= n;
+            }
+            difference_type operator-(const TRandomAccessIterator& other) const {
+                return (Position_ - other.Position_) / Step_;
+            }
+            bool operator!=(const TRandomAccessIterator& other) const {
+                return Position_ != other.Position_;
+            }
+            bool operator==(const TRandomAccessIterator& other) const {
+                return Position_ == other.Position_;
+            }
+            bool operator<(const TRandomAccessIterator& other) const {
+                return Position_ < other.Position_;
+            }
+            bool operator>(const TRandomAccessIterator& other) const {
+                return Position_ > other.Position_;
+            }
+            bool operator<=(const TRandomAccessIterator& other) const {
+                return Position_ <= other.Position_;
+            }
+            bool operator>=(const TRandomAccessIterator& other) const {
+                return Position_ >= other.Position_;
+            }
+
+            TIteratorState Begin_;
+            difference_type Size_;
+            difference_type Step_;
+            //! Index of the first element of the chunk in the container
+            difference_type Position_;
+        };
+
+        struct TInputSentinel {
+        };
+
+        struct TInputIterator {
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::decay_t<TValue>;
+            using pointer = value_type*;
+            using reference = TValue;
+            using iterator_category = std::input_iterator_tag;
+
+            TValue operator*() const {
+                if constexpr (StaticSize != 0) {
+                    return Buffer_;
+                } else {
+                    return {Buffer_.data(), Buffer_.data() + Filled_};
+                }
+            }
+            TInputIterator& operator++() {
+                Fill();
+                return *this;
+            }
+            bool operator!=(const TInputSentinel&) const {
+                return Filled_ != 0;
+            }
+            bool operator==(const TInputSentinel&) const {
+                return Filled_ == 0;
+            }
+
+            //! Collects the next chunk into the buffer, Filled_ is 0 when the chunk is the last one
+            void Fill() {
+                const auto last = std::end(*Chunker_->Storage_.Ptr());
+                Filled_ = 0;
+                if constexpr (StaticSize != 0) {
+                    for (; Filled_ < StaticSize && Current_ != last; ++Current_) {
+                        Buffer_[Filled_++] = *Current_;
+                    }
+                    if (Filled_ < StaticSize) {
+                        Chunker_->SaveRemainder(Buffer_, Filled_);
+                        Filled_ = 0;
+                    }
+                } else {
+                    Buffer_.clear();
+                    for (; std::ptrdiff_t(Filled_) < Chunker_->Step_ && Current_ != last; ++Current_) {
+                        Buffer_.push_back(*Current_);
+                        ++Filled_;
+                    }
+                }
+            }
+
+            TIteratorState Current_;
+            const TChunker* Chunker_;
+            std::size_t Filled_;
+            //! Every iterator has its own chunk, so iterators (and empty()) do not overwrite chunks of each other
+            mutable TBuffer Buffer_ = {};
+        };
+
+        using TIterator = std::conditional_t<RandomAccess, TRandomAccessIterator, TInputIterator>;
+        using TSentinel = std::conditional_t<RandomAccess, TRandomAccessIterator, TInputSentinel>;
+
+        std::ptrdiff_t Size() const {
+            return std::end(*Storage_.Ptr()) - std::begin(*Storage_.Ptr());
+        }
+
+        //! Number of chunks of random access container
+        std::ptrdiff_t ChunkCount() const {
+            if constexpr (StaticSize != 0) {
+                return Size() / Step_;
+            } else {
+                return (Size() + Step_ - 1) / Step_;
+            }
+        }
+
+        //! Incomplete last chunk of a buffered range is kept for Remainder()
+        void SaveRemainder(const TBuffer& buffer, std::size_t size) const {
+            std::copy_n(buffer.begin(), size, Remainder_.begin());
+            RemainderSize_ = size;
+        }
+
+    public:
+        using iterator = TIterator;
+        using const_iterator = TIterator;
+        using size_type = std::size_t;
+
+        TIterator begin() const {
+            if constexpr (RandomAccess) {
+                return {std::begin(*Storage_.Ptr()), Size(), Step_, 0};
+            } else {
+                TIterator iterator{std::begin(*Storage_.Ptr()), this, 0};
+                if constexpr (StaticSize == 0) {
+                    iterator.Buffer_.reserve(Step_);
+                }
+                iterator.Fill();
+                return iterator;
+            }
+        }
+
+        TSentinel end() const {
+            if constexpr (RandomAccess) {
+                return {std::begin(*Storage_.Ptr()), Size(), Step_, ChunkCount() * Step_};
+            } else {
+                return {};
+            }
+        }
+
+        size_type size() const {
+            static_assert(RandomAccess, "Chunks of buffered ranges have no size");
+            return ChunkCount();
+        }
+
+        bool empty() const {
+            return !(begin() != end());
+        }
+
+        TValue operator[](size_type at) const {
+            static_assert(RandomAccess);
+            return begin()[at];
+        }
+
+        //! Elements after the last full chunk of Chunks<N>
+        //! Buffered ranges know them only when iteration is finished
+        auto Remainder() const {
+            static_assert(StaticSize != 0, "Chunks with runtime size yield the incomplete chunk as the last one");
+            if constexpr (RandomAccess) {
+                auto first = std::begin(*Storage_.Ptr());
+                return MakeIteratorRange(first + ChunkCount() * Step_, std::end(*Storage_.Ptr()));
+            } else {
+                return MakeIteratorRange(Remainder_.data(), Remainder_.data() + RemainderSize_);
+            }
+        }
+
+        TSizeHint SizeHint() const {
+            TSizeHint hint = ::SizeHint(*Storage_.Ptr());
+            if constexpr (StaticSize != 0) {
+                hint.Size /= Step_;
+            } else {
+                hint.Size = (hint.Size + Step_ - 1) / Step_;
+            }
+            return hint;
+        }
+
+        template <typename TFunction>
+        void ForEach(TFunction&& fn) const {
+            if constexpr (RandomAccess) {
+                for (auto it = begin(), last = end(); it != last; ++it) {
+                    fn(*it);
+                }
+            } else if constexpr (StaticSize != 0) {
+                TBuffer buffer;
+                std::size_t filled = 0;
+                ::ForEach(*Storage_.Ptr(), [&buffer, &fn, &filled](auto&& x) {
+                    buffer[filled++] = std::forward<decltype(x)>(x);
+                    if (filled == StaticSize) {
+                        fn(static_cast<const TArray&>(buffer));
+                        filled = 0;
+                    }
+                });
+                SaveRemainder(buffer, filled);
+            } else {
+                TBuffer buffer;
+                buffer.reserve(Step_);
+                ::ForEach(*Storage_.Ptr(), [this, &buffer, &fn](auto&& x) {
+                    buffer.push_back(std::forward<decltype(x)>(x));
+                    if (std::ptrdiff_t(buffer.size()) == Step_) {
+                        fn(TValue{buffer.data(), buffer.data() + buffer.size()});
+                        buffer.clear();
+                    }
+                });
+                if (!buffer.empty()) {
+                    fn(TValue{buffer.data(), buffer.data() + buffer.size()});
+                }
+            }
+        }
+
+        mutable TStorage Storage_;
+        std::ptrdiff_t Step_;
+        //! Elements after the last full chunk of Chunks<N> over a buffered range, written when iteration is finished
+        mutable TBuffer Remainder_ = {};
+        mutable std::size_t RemainderSize_ = 0;
+    };
+
+}
+
+//! Splits range into chunks of `size` elements, the last chunk may be shorter
+//! Usage: for (auto chunk : Chunks(a, 1024)) { for (auto& x : chunk) {...} }
+//! Throws std::invalid_argument if size is 0
+template <typename TContainerOrRef>
+auto Chunks(TContainerOrRef&& container, std::size_t size) {
+    if (size == 0) {
+        throw std::invalid_argument("Chunks: size of chunk must be positive");
+    }
+    return NPrivate::TChunker<TContainerOrRef, 0>{std::forward<TContainerOrRef>(container), std::ptrdiff_t(size)};
+}
+
+//! Splits range into std::array<T, Size> chunks, elements which do not fill the whole chunk are in Remainder()
+//! Usage: auto chunks = Chunks<8>(a); for (const auto& chunk : chunks) {...} for (auto& x : chunks.Remainder()) {...}
+template <std::size_t Size, typename TContainerOrRef>
+auto Chunks(TContainerOrRef&& container) {
+    static_assert(Size != 0, "Chunk can not be empty");
+    return NPrivate::TChunker<TContainerOrRef, Size>{std::forward<TContainerOrRef>(container), std::ptrdiff_t(Size)};
+}
@@ -1,5 +1,12 @@
 #pragma once
 
+#include "block.h"
+#include "for_each.h"
+#include "size_hint.h"
+#include "static_extent.h"
+#include "traits.h"
+
+#include <util/generic/iterator_range.h>
 #include <util/generic/store_policy.h>
 
 #include <iterator>
@@ -18,14 +25,24 @@ namespace NPrivate {
             using TIteratorState = std::tuple<decltype(std::begin(std::declval<TContainers&>()))...>;
             using TSentinelState = std::tuple<decltype(std::end(std::declval<TContainers&>()))...>;
 
+            static constexpr bool TrivialSentinel = std::is_same_v<TIteratorState, TSentinelState>;
+
+        public:
+            //! Iterator can go back across the borders of containers, so Reversed(Concatenate(a, b)) works
+            static constexpr bool Bidirectional = TrivialSentinel && (HasBidirectionalIterator<TContainers>(0) && ...);
+
+            //! Sum of the inputs if all of them are known at compile time
+            static constexpr std::size_t Extent = SumExtent<TContainers...>();
+
+        private:
+
             struct TIterator;
             struct TSentinelCandidate {
                 TSentinelState Iterators_;
                 std::size_t Position_;
-                THolders* HoldersPtr_;
+                const THolders* HoldersPtr_;
             };
-            using TSentinel = std::conditional_t<std::is_same_v<TIteratorState, TSentinelState>,
-                                                 TIterator, TSentinelCandidate>;
+            using TSentinel = std::conditional_t<TrivialSentinel, TIterator, TSentinelCandidate>;
 
             struct TIterator {
             private:
@@ -33,7 +50,7 @@ namespace NPrivate {
 
                 // important, that it is a static function, compiler better optimizes such code
                 template <std::size_t index = 0, typename TMaybeConstIteratorState>
-                static TValue GetCurrentValue(std::size_t position, TMaybeConstIteratorState& iterators) {
+                static constexpr TValue GetCurrentValue(std::size_t position, TMaybeConstIteratorState& iterators) {
                     if constexpr (index >= sizeof...(TContainers)) {
                         // never happened when use of iterator is correct
                         return *std::get<0>(iterators);
@@ -47,7 +64,7 @@ namespace NPrivate {
                 }
 
                 template <bool needIncrement, std::size_t index = 0>
-                void MaybeIncrementIteratorAndSkipExhaustedContainers() {
+                constexpr void MaybeIncrementIteratorAndSkipExhaustedContainers() {
                     if constexpr (index >= sizeof...(TContainers)) {
                         return;
                     } else {
@@ -64,23 +81,56 @@ namespace NPrivate {
                         }
                     }
                 }
+
+                //! Containers before Position_ are exhausted (their iterators are at end), empty ones are skipped
+                template <std::size_t index = sizeof...(TContainers) - 1>
+                constexpr void DecrementIteratorAndSkipExhaustedContainers() {
+                    if (Position_ >= index) {
+                        auto& iterator = std::get<index>(Iterators_);
+                        if (iterator != std::begin(*std::get<index>(*HoldersPtr_).Ptr())) {
+                            --iterator;
+                            Position_ = index;
+                            return;
+                        }
+                    }
+                    if constexpr (index > 0) {
+                        DecrementIteratorAndSkipExhaustedContainers<index - 1>();
+                    }
+                }
             public:
                 using difference_type = std::ptrdiff_t;
-                using value_type = TValue;
+                using value_type = std::decay_t<TValue>;
                 using pointer = std::remove_reference_t<TValue>*;
-                using reference = std::remove_reference_t<TValue>&;
-                using iterator_category = std::input_iterator_tag;
+                using reference = TValue;
+                using iterator_category = std::conditional_t<Bidirectional,
+                    std::bidirectional_iterator_tag, std::input_iterator_tag>;
 
-                TValue operator*() {
+                constexpr TValue operator*() {
                     return GetCurrentValue(Position_, Iterators_);
                 }
-                TValue operator*() const {
+                constexpr TValue operator*() const {
                     return GetCurrentValue(Position_, Iterators_);
                 }
-                void operator++() {
+                constexpr TIterator& operator++() {
                     MaybeIncrementIteratorAndSkipExhaustedContainers<true>();
+                    return *this;
+                }
+                constexpr TIterator operator++(int) {
+                    TIterator result = *this;
+                    ++*this;
+                    return result;
+                }
+                constexpr TIterator& operator--() {
+                    static_assert(Bidirectional);
+                    DecrementIteratorAndSkipExhaustedContainers();
+                    return *this;
+                }
+                constexpr TIterator operator--(int) {
+                    TIterator result = *this;
+                    --*this;
+                    return result;
                 }
-                bool operator!=(const TSentinel& other) const {
+                constexpr bool operator!=(const TSentinel& other) const {
                     // give compiler an opportunity to optimize sentinel case (-70% of time)
                     if (other.Position_ == sizeof...(TContainers)) {
                         return Position_ < sizeof...(TContainers);
@@ -89,33 +139,81 @@ namespace NPrivate {
                                 ((std::get<I>(Iterators_) != std::get<I>(other.Iterators_)) || ...));
                     }
                 }
-                bool operator==(const TSentinel& other) const {
+                constexpr bool operator==(const TSentinel& other) const {
                     return !(*this != other);
                 }
 
                 TIteratorState Iterators_;
                 std::size_t Position_;
-                THolders* HoldersPtr_;
+                const THolders* HoldersPtr_;
             };
         public:
             using iterator = TIterator;
             using const_iterator = TIterator;
 
-            TIterator begin() const {
+            constexpr TIterator begin() const {
                 TIterator iterator{TIteratorState{std::begin(*std::get<I>(Holders_).Ptr())...}, 0, &Holders_};
                 iterator.template MaybeIncrementIteratorAndSkipExhaustedContainers<false>();
                 return iterator;
             }
 
-            TSentinel end() const {
+            constexpr TSentinel end() const {
                 return {TSentinelState{std::end(*std::get<I>(Holders_).Ptr())...}, sizeof...(TContainers), &Holders_};
             }
 
-            mutable THolders Holders_;
+            //! Segmented iteration is possible when every input is an ordinary [begin, end) range,
+            //! so plain std algorithms can be run on each segment
+            static constexpr bool Segmented = TrivialSentinel;
+
+            //! One TIteratorRange per input container
+            constexpr auto Segments() const {
+                static_assert(Segmented);
+                return std::make_tuple(
+                    MakeIteratorRange(std::begin(*std::get<I>(Holders_).Ptr()), std::end(*std::get<I>(Holders_).Ptr()))...);
+            }
+
+            //! Makes the iterator of the whole concatenation from the local iterator of the segment number `index`
+            template <std::size_t index>
+            constexpr TIterator SegmentIterator(std::tuple_element_t<index, TIteratorState> local) const {
+                static_assert(Segmented);
+                TIterator iterator{TIteratorState{
+                    (I < index ? std::end(*std::get<I>(Holders_).Ptr()) : std::begin(*std::get<I>(Holders_).Ptr()))...},
+                    index, &Holders_};
+                std::get<index>(iterator.Iterators_) = local;
+                iterator.template MaybeIncrementIteratorAndSkipExhaustedContainers<false>();
+                return iterator;
+            }
+
+            TSizeHint SizeHint() const {
+                return (::SizeHint(*std::get<I>(Holders_).Ptr()) + ...);
+            }
+
+            template <typename TFunction>
+            void ForEach(TFunction&& fn) const {
+                // no position dispatching at all, just loops one after another
+                auto push = [&fn](auto&& x) {
+                    fn(static_cast<TValue>(std::forward<decltype(x)>(x)));
+                };
+                (::ForEach(*std::get<I>(Holders_).Ptr(), push), ...);
+            }
+
+            //! Block is refilled from the next container when the current one is exhausted
+            auto BlockReader() const {
+                using TInputs = std::tuple<decltype(::BlockReader(*std::get<I>(Holders_).Ptr()))...>;
+                using TFirstBlock = typename std::tuple_element_t<0, TInputs>::TBlockType;
+                if constexpr (((std::tuple_element_t<I, TInputs>::Dense &&
+                                std::is_same_v<typename std::tuple_element_t<I, TInputs>::TBlockType, TFirstBlock>) && ...)) {
+                    return TConcatenateBlockReader<std::tuple_element_t<I, TInputs>...>{{::BlockReader(*std::get<I>(Holders_).Ptr())...}};
+                } else {
+                    return IteratorBlockReader(*this);
+                }
+            }
+
+            THolders Holders_;
         };
 
         template <std::size_t... I>
-        static auto Concatenate(TContainers&&... containers, std::index_sequence<I...>) {
+        static constexpr auto Concatenate(TContainers&&... containers, std::index_sequence<I...>) {
             return TConcatenatorWithIndex<I...>{{std::forward<TContainers>(containers)...}};
         }
     };
@@ -125,7 +223,7 @@ namespace NPrivate {
 
 //! Usage: for (auto x : Concatenate(a, b)) {...}
 template <typename TFirstContainer, typename... TContainers>
-auto Concatenate(TFirstContainer&& container, TContainers&&... containers) {
+constexpr auto Concatenate(TFirstContainer&& container, TContainers&&... containers) {
     return NPrivate::TConcatenator<decltype(*std::begin(container)), TFirstContainer, TContainers...>::Concatenate(
         std::forward<TFirstContainer>(container), std::forward<TContainers>(containers)...,
         std::make_index_sequence<sizeof...(TContainers) + 1>{});
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "block_mask.h"
+#include "for_each.h"
+#include "thread_pool.h"
+#include "traits.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+/** @file
+ * Parallel order-preserving compaction of random access ranges (parallel std::copy_if).
+ * The first pass evaluates the condition into bitmasks and counts survivors of every block,
+ * exclusive prefix sum of the counts gives the output position of every block,
+ * the second pass scatters survivors of every block to its own part of the presized output.
+ * No locks and no reallocations, the condition is called once per element.
+ */
+
+namespace NPrivate {
+
+    //! Elements per task, multiple of BlockMaskSize
+    static constexpr std::ptrdiff_t CompactionBlockSize = 1 << 14;
+
+    //! Bit j is condition(element number offset + j), size <= BlockMaskSize
+    template <typename TContainer, typename TIterator, typename TCondition>
+    TBlockMask CalcRangeMask(TContainer& container, const TIterator& first, std::ptrdiff_t offset, std::ptrdiff_t size, TCondition& condition) {
+        if constexpr (HasArithmeticData<TContainer>(0, nullptr)) {
+            // vectorized for plain arrays of numbers
+            return CalcBlockMask(std::data(container) + offset, size, condition);
+        } else {
+            TBlockMask mask = 0;
+            auto it = first + offset;
+            for (std::ptrdiff_t j = 0; j < size; ++j, ++it) {
+                mask |= TBlockMask(bool(condition(*it))) << j;
+            }
+            return mask;
+        }
+    }
+
+    //! allocate(count) returns random access iterator to the place for `count` survivors
+    template <typename TContainer, typename TCondition, typename TAllocate>
+    auto Compact(TContainer& container, TCondition& condition, std::size_t threads, TAllocate&& allocate) {
+        const auto first = std::begin(container);
+        const std::ptrdiff_t size = std::end(container) - first;
+        const std::ptrdiff_t blockCount = (size + CompactionBlockSize - 1) / CompactionBlockSize;
+        std::vector<TBlockMask> masks((size + BlockMaskSize - 1) / BlockMaskSize);
+        std::vector<std::ptrdiff_t> offsets(blockCount);
+
+        ParallelFor(blockCount, threads, 1, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            for (std::ptrdiff_t block = begin; block < end; ++block) {
+                const std::ptrdiff_t blockEnd = std::min(size, (block + 1) * CompactionBlockSize);
+                std::ptrdiff_t count = 0;
+                for (std::ptrdiff_t j = block * CompactionBlockSize; j < blockEnd; j += BlockMaskSize) {
+                    auto mask = CalcRangeMask(container, first, j, std::min(BlockMaskSize, blockEnd - j), condition);
+                    masks[j / BlockMaskSize] = mask;
+                    count += PopCount(mask);
+                }
+                offsets[block] = count;
+            }
+        });
+
+        std::ptrdiff_t total = 0;
+        for (auto& offset : offsets) {
+            total += std::exchange(offset, total);
+        }
+        auto out = allocate(total);
+
+        ParallelFor(blockCount, threads, 1, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            for (std::ptrdiff_t block = begin; block < end; ++block) {
+                const std::ptrdiff_t blockEnd = std::min(size, (block + 1) * CompactionBlockSize);
+                auto destination = out + offsets[block];
+                for (std::ptrdiff_t j = block * CompactionBlockSize; j < blockEnd; j += BlockMaskSize) {
+                    for (auto mask = masks[j / BlockMaskSize]; mask; mask &= mask - 1) {
+                        *destination = *(first + (j + LowestBit(mask)));
+                        ++destination;
+                    }
+                }
+            }
+        });
+        return out + total;
+    }
+
+}
+
+//! Appends elements of the range satisfying the condition to `out` (e.g. std::vector), keeps their order
+//! Random access ranges are processed by several threads, the condition must be thread-safe
+//! Usage: FilterInto(result, [](int x) { return x > 0; }, column);
+template <typename TOutputContainer, typename TCondition, typename TContainerOrRef>
+void FilterInto(TOutputContainer& out, TCondition&& condition, TContainerOrRef&& container, std::size_t threads = 0) {
+    if constexpr (NPrivate::HasRandomAccessRange<TContainerOrRef>()) {
+        NPrivate::Compact(container, condition, threads, [&out](std::ptrdiff_t count) {
+            const auto oldSize = out.size();
+            out.resize(oldSize + count);
+            return out.begin() + oldSize;
+        });
+    } else {
+        ::ForEach(container, [&out, &condition](auto&& x) {
+            if (condition(x)) {
+                out.push_back(std::forward<decltype(x)>(x));
+            }
+        });
+    }
+}
+
+//! std::copy_if, parallel when both the range and the output iterator are random access
+//! Usage: auto end = CopyIf(column, result.begin(), [](int x) { return x > 0; });
+template <typename TContainerOrRef, typename TOutputIterator, typename TCondition>
+TOutputIterator CopyIf(TContainerOrRef&& container, TOutputIterator out, TCondition&& condition, std::size_t threads = 0) {
+    using TOutputCategory = typename std::iterator_traits<TOutputIterator>::iterator_category;
+    if constexpr (NPrivate::HasRandomAccessRange<TContainerOrRef>() &&
+                  std::is_same_v<TOutputCategory, std::random_access_iterator_tag>) {
+        return NPrivate::Compact(container, condition, threads, [out](std::ptrdiff_t) {
+            return out;
+        });
+    } else {
+        ::ForEach(container, [&out, &condition](auto&& x) {
+            if (condition(x)) {
+                *out = std::forward<decltype(x)>(x);
+                ++out;
+            }
+        });
+        return out;
+    }
+}
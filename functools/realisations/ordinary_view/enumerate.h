@@ -1,5 +1,10 @@
 #pragma once
 
+#include "for_each.h"
+#include "size_hint.h"
+#include "static_extent.h"
+#include "traits.h"
+
 #include <util/generic/store_policy.h>
 
 #include <iterator>
@@ -9,72 +14,222 @@
 
 namespace NPrivate {
 
-    template <typename TContainer>
+    template <typename TContainer, typename TIndex = std::size_t>
     struct TEnumerator {
     private:
         using TStorage = TAutoEmbedOrPtrPolicy<TContainer>;
-        using TValue = std::tuple<const std::size_t, decltype(*std::begin(std::declval<TContainer&>()))>;
+        using TValue = std::tuple<const TIndex, decltype(*std::begin(std::declval<TContainer&>()))>;
         using TIteratorState = decltype(std::begin(std::declval<TContainer&>()));
         using TSentinelState = decltype(std::end(std::declval<TContainer&>()));
 
         static constexpr bool TrivialSentinel = std::is_same_v<TIteratorState, TSentinelState>;
 
-        struct TIterator;
+    public:
+        //! Iterator keeps begin of the container and the position, index is computed from the position
+        static constexpr bool RandomAccess = TrivialSentinel && HasRandomAccessIterator<TContainer>(0);
+
+        //! Number of elements is known before iteration
+        static constexpr bool Sized = RandomAccess || HasSize<TContainer>(0);
+
+        //! Index of end() is known from the size, so reverse iteration yields the original indexes
+        static constexpr bool Bidirectional = RandomAccess ||
+            (TrivialSentinel && HasBidirectionalIterator<TContainer>(0) && HasSize<TContainer>(0));
+
+        //! Number of elements if it is known at compile time (std::array, C array)
+        static constexpr std::size_t Extent = StaticExtent<TContainer>();
+
+    private:
+        struct TInputIterator;
+        struct TRandomAccessIterator;
+        using TIterator = std::conditional_t<RandomAccess, TRandomAccessIterator, TInputIterator>;
         struct TSentinelCandidate {
             TSentinelState Iterator_;
         };
         using TSentinel = std::conditional_t<TrivialSentinel, TIterator, TSentinelCandidate>;
 
-        struct TIterator {
+        struct TInputIterator {
             using difference_type = std::ptrdiff_t;
-            using value_type = TValue;
+            using value_type = std::decay_t<TValue>;
             using pointer = TValue*;
-            using reference = TValue&;
-            using iterator_category = std::input_iterator_tag;
+            using reference = TValue;
+            using iterator_category = std::conditional_t<Bidirectional,
+                std::bidirectional_iterator_tag, std::input_iterator_tag>;
 
-            TValue operator*() {
+            constexpr TValue operator*() {
                 return {Index_, *Iterator_};
             }
-            TValue operator*() const {
+            constexpr TValue operator*() const {
                 return {Index_, *Iterator_};
             }
-            void operator++() {
+            constexpr TInputIterator& operator++() {
                 ++Index_;
                 ++Iterator_;
+                return *this;
+            }
+            constexpr TInputIterator& operator--() {
+                static_assert(Bidirectional);
+                --Index_;
+                --Iterator_;
+                return *this;
+            }
+            constexpr TInputIterator operator--(int) {
+                TInputIterator result = *this;
+                --*this;
+                return result;
             }
-            bool operator!=(const TSentinel& other) const {
+            constexpr bool operator!=(const TSentinel& other) const {
                 return Iterator_ != other.Iterator_;
             }
-            bool operator==(const TSentinel& other) const {
+            constexpr bool operator==(const TSentinel& other) const {
                 return Iterator_ == other.Iterator_;
             }
 
-            std::size_t Index_;
+            TIndex Index_;
             TIteratorState Iterator_;
         };
+
+        struct TRandomAccessIterator {
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::decay_t<TValue>;
+            using pointer = TValue*;
+            using reference = TValue;
+            using iterator_category = std::random_access_iterator_tag;
+
+            constexpr TValue operator*() const {
+                return {TIndex(Start_ + Position_), *(Begin_ + Position_)};
+            }
+            constexpr TValue operator[](difference_type n) const {
+                return {TIndex(Start_ + Position_ + n), *(Begin_ + (Position_ + n))};
+            }
+            constexpr TRandomAccessIterator& operator++() {
+                ++Position_;
+                return *this;
+            }
+            constexpr TRandomAccessIterator operator++(int) {
+                TRandomAccessIterator result = *this;
+                ++Position_;
+                return result;
+            }
+            constexpr TRandomAccessIterator& operator--() {
+                --Position_;
+                return *this;
+            }
+            constexpr TRandomAccessIterator operator--(int) {
+                TRandomAccessIterator result = *this;
+                --Position_;
+                return result;
+            }
+            constexpr TRandomAccessIterator& operator+=(difference_type n) {
+                Position_ += n;
+                return *this;
+            }
+            constexpr TRandomAccessIterator& operator-=(difference_type n) {
+                Position_ -= n;
+                return *this;
+            }
+            constexpr TRandomAccessIterator operator+(difference_type n) const {
+                return {Begin_, Position_ + n, Start_};
+            }
+            friend constexpr TRandomAccessIterator operator+(difference_type n, const TRandomAccessIterator& iterator) {
+                return iterator + n;
+            }
+            constexpr TRandomAccessIterator operator-(difference_type n) const {
+                return {Begin_, Position_ - n, Start_};
+            }
+            constexpr difference_type operator-(const TRandomAccessIterator& other) const {
+                return Position_ - other.Position_;
+            }
+            constexpr bool operator!=(const TRandomAccessIterator& other) const {
+                return Position_ != other.Position_;
+            }
+            constexpr bool operator==(const TRandomAccessIterator& other) const {
+                return Position_ == other.Position_;
+            }
+            constexpr bool operator<(const TRandomAccessIterator& other) const {
+                return Position_ < other.Position_;
+            }
+            constexpr bool operator>(const TRandomAccessIterator& other) const {
+                return Position_ > other.Position_;
+            }
+            constexpr bool operator<=(const TRandomAccessIterator& other) const {
+                return Position_ <= other.Position_;
+            }
+            constexpr bool operator>=(const TRandomAccessIterator& other) const {
+                return Position_ >= other.Position_;
+            }
+
+            TIteratorState Begin_;
+            difference_type Position_;
+            TIndex Start_;
+        };
     public:
         using iterator = TIterator;
         using const_iterator = TIterator;
+        using size_type = std::size_t;
 
-        TIterator begin() const {
-            return {0, std::begin(*Storage_.Ptr())};
+        constexpr TIterator begin() const {
+            if constexpr (RandomAccess) {
+                return {std::begin(*Storage_.Ptr()), 0, Start_};
+            } else {
+                return {Start_, std::begin(*Storage_.Ptr())};
+            }
         }
 
-        TSentinel end() const {
-            if constexpr (TrivialSentinel) {
-                return TIterator{std::numeric_limits<std::size_t>::max(), std::end(*Storage_.Ptr())};
+        constexpr TSentinel end() const {
+            if constexpr (RandomAccess) {
+                return {std::begin(*Storage_.Ptr()), std::end(*Storage_.Ptr()) - std::begin(*Storage_.Ptr()), Start_};
+            } else if constexpr (Bidirectional) {
+                return TIterator{TIndex(Start_ + std::size(*Storage_.Ptr())), std::end(*Storage_.Ptr())};
+            } else if constexpr (TrivialSentinel) {
+                return TIterator{std::numeric_limits<TIndex>::max(), std::end(*Storage_.Ptr())};
             } else {
                 return TSentinel{std::end(*Storage_.Ptr())};
             }
         }
 
-        mutable TStorage Storage_;
+        //! Declared only for sized containers, so HasSize of outer adaptors is not misled
+        template <bool S = Sized, std::enable_if_t<S, int> = 0>
+        constexpr size_type size() const {
+            if constexpr (RandomAccess) {
+                return std::end(*Storage_.Ptr()) - std::begin(*Storage_.Ptr());
+            } else {
+                return std::size(*Storage_.Ptr());
+            }
+        }
+
+        constexpr bool empty() const {
+            return !(std::begin(*Storage_.Ptr()) != std::end(*Storage_.Ptr()));
+        }
+
+        template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+        constexpr TValue operator[](size_type at) const {
+            return begin()[at];
+        }
+
+        TSizeHint SizeHint() const {
+            return ::SizeHint(*Storage_.Ptr());
+        }
+
+        template <typename TFunction>
+        void ForEach(TFunction&& fn) const {
+            TIndex index = Start_;
+            ::ForEach(*Storage_.Ptr(), [&fn, &index](auto&& x) {
+                fn(TValue{index++, std::forward<decltype(x)>(x)});
+            });
+        }
+
+        TStorage Storage_;
+        TIndex Start_;
     };
 
 }
 
+//! Acts as pythonic enumerate, start and type of indexes are configurable
+//! Narrow TIndex (e.g. uint32_t) lets compiler use more SIMD lanes with 32-bit data
 //! Usage: for (auto [i, x] : Enumerate(container)) {...}
-template <typename TContainerOrRef>
-auto Enumerate(TContainerOrRef&& container) {
-    return NPrivate::TEnumerator<TContainerOrRef>{std::forward<TContainerOrRef>(container)};
+//!        for (auto [i, x] : Enumerate<uint32_t>(container, 1)) {...}
+template <typename TIndex = std::size_t, typename TContainerOrRef>
+constexpr auto Enumerate(TContainerOrRef&& container, TIndex start = 0) {
+    static_assert(std::is_integral_v<TIndex>, "Index of Enumerate should be integral");
+    return NPrivate::TEnumerator<TContainerOrRef, TIndex>{std::forward<TContainerOrRef>(container), start};
 }
@@ -1,104 +1,321 @@
 #pragma once
 
+#include "block.h"
+#include "block_mask.h"
+#include "for_each.h"
+#include "size_hint.h"
+#include "traits.h"
+
 #include <util/generic/store_policy.h>
 
+#include <algorithm>
 #include <iterator>
 #include <limits>
+#include <optional>
 #include <tuple>
 
 
 namespace NPrivate {
 
-    template <typename TContainer, typename TCondition>
+    template <typename TValue, bool Enabled, bool InPlace = std::is_trivially_copyable_v<TValue> &&
+        std::is_trivially_default_constructible_v<TValue> && std::is_copy_assignable_v<TValue>>
+    struct TFilterValueCache {
+    };
+
+    template <typename TValue>
+    struct TFilterValueCache<TValue, true, false> {
+        template <typename TFrom>
+        void Cache(TFrom&& value) {
+            Cached_.emplace(std::forward<TFrom>(value));
+        }
+
+        TValue& CachedValue() {
+            return *Cached_;
+        }
+
+        const TValue& CachedValue() const {
+            return *Cached_;
+        }
+
+        std::optional<TValue> Cached_;
+    };
+
+    //! Trivial values are assigned in place (std::optional::emplace is not constexpr), so Filter works in constant expressions
+    template <typename TValue>
+    struct TFilterValueCache<TValue, true, true> {
+        template <typename TFrom>
+        constexpr void Cache(TFrom&& value) {
+            Cached_ = std::forward<TFrom>(value);
+        }
+
+        constexpr TValue& CachedValue() {
+            return Cached_;
+        }
+
+        constexpr const TValue& CachedValue() const {
+            return Cached_;
+        }
+
+        std::remove_const_t<TValue> Cached_{};
+    };
+
+    template <typename TContainer, typename TCondition, bool BlockMaskRequested = false>
     struct TFilterer {
     private:
-        using TContainerStorage = TAutoEmbedOrPtrPolicy<TContainer>;
-        using TConditionStorage = TAutoEmbedOrPtrPolicy<TCondition>;
         using TValue = decltype(*std::begin(std::declval<TContainer&>()));
+        using TContainerStorage = TAutoEmbedOrPtrPolicy<TContainer>;
+        //! Condition held by value is const if it can be called as const, so Filter stays constexpr
+        using TConditionStorage = TAutoEmbedOrPtrPolicy<TCondition, std::is_reference_v<TCondition>,
+            std::is_invocable_v<const std::remove_reference_t<TCondition>&, TValue>>;
+        using TContainerPtr = decltype(std::declval<const TContainerStorage&>().Ptr());
+        using TConditionPtr = decltype(std::declval<const TConditionStorage&>().Ptr());
         using TIteratorState = decltype(std::begin(std::declval<TContainer&>()));
         using TSentinelState = decltype(std::end(std::declval<TContainer&>()));
 
         static constexpr bool TrivialSentinel = std::is_same_v<TIteratorState, TSentinelState>;
 
-        struct TIterator;
+    public:
+        //! FilterBlockMask over a contiguous container of arithmetic values: predicate is evaluated over blocks into a bitmask.
+        //! Predicate is called for every element exactly once and in order, but up to BlockMaskSize elements
+        //! ahead of iteration, so it is used only on request. Plain Filter calls the predicate lazily
+        static constexpr bool BlockMask = BlockMaskRequested && HasArithmeticData<TContainer>(0, nullptr);
+
+        //! Input yields temporaries (e.g. Map(f, a)): the value is computed once, kept in the iterator
+        //! and used both for the predicate and for operator*, so f is called once per element
+        static constexpr bool CacheValue = !std::is_reference_v<TValue>;
+
+        //! Iterator goes back to the previous accepted element, so Reversed(Filter(f, a)) works
+        static constexpr bool Bidirectional = BlockMask || (TrivialSentinel && HasBidirectionalIterator<TContainer>(0));
+
+    private:
+        struct TScalarIterator;
+        struct TBlockIterator;
+        using TIterator = std::conditional_t<BlockMask, TBlockIterator, TScalarIterator>;
         struct TSentinelCandidate {
             TSentinelState Iterator_;
         };
         using TSentinel = std::conditional_t<TrivialSentinel, TIterator, TSentinelCandidate>;
+        using TElement = std::remove_reference_t<TValue>;
+
+        struct TBlockIterator {
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::decay_t<TValue>;
+            using pointer = TElement*;
+            using reference = TValue;
+            using iterator_category = std::bidirectional_iterator_tag;
+
+            constexpr TValue operator*() const {
+                return Block_[LowestBit(Mask_)];
+            }
+            constexpr TBlockIterator& operator++() {
+                Mask_ &= Mask_ - 1;
+                SkipEmptyBlocks();
+                return *this;
+            }
+            //! Full_ keeps the mask of the current block, so going back within the block calls no predicate
+            constexpr TBlockIterator& operator--() {
+                TBlockMask before;
+                if (Block_ == End_) {
+                    Block_ = Begin_ + (End_ - Begin_ - 1) / BlockMaskSize * BlockMaskSize;
+                    Full_ = CalcBlockMask(Block_, End_ - Block_, *Condition_);
+                    before = Full_;
+                } else {
+                    before = Full_ & ((Mask_ & (~Mask_ + 1)) - 1);
+                }
+                while (!before) {
+                    Block_ -= BlockMaskSize;
+                    Full_ = CalcBlockMask(Block_, BlockMaskSize, *Condition_);
+                    before = Full_;
+                }
+                Mask_ = Full_ & ~((TBlockMask(1) << HighestBit(before)) - 1);
+                return *this;
+            }
+            constexpr bool operator!=(const TBlockIterator& other) const {
+                return Block_ != other.Block_ || Mask_ != other.Mask_;
+            }
+            constexpr bool operator==(const TBlockIterator& other) const {
+                return !(*this != other);
+            }
 
-        struct TIterator {
+            constexpr void SkipEmptyBlocks() {
+                while (!Mask_) {
+                    if (End_ - Block_ <= BlockMaskSize) {
+                        Block_ = End_;
+                        return;
+                    }
+                    Block_ += BlockMaskSize;
+                    Mask_ = Full_ = CalcBlockMask(Block_, std::min(End_ - Block_, BlockMaskSize), *Condition_);
+                }
+            }
+
+            TElement* Begin_;
+            TElement* Block_;
+            TElement* End_;
+            //! Elements of the block not visited yet, the lowest bit is the current element
+            TBlockMask Mask_;
+            TBlockMask Full_;
+            TConditionPtr Condition_;
+        };
+
+        struct TScalarIterator : TFilterValueCache<TValue, CacheValue> {
             using difference_type = std::ptrdiff_t;
-            using value_type = TValue;
+            using value_type = std::decay_t<TValue>;
             using pointer = std::remove_reference_t<TValue>*;
-            using reference = TValue&;
-            using iterator_category = std::input_iterator_tag;
+            using reference = TValue;
+            using iterator_category = std::conditional_t<Bidirectional,
+                std::bidirectional_iterator_tag, std::input_iterator_tag>;
 
-            TValue operator*() {
-                return *Iterator_;
+            constexpr TValue operator*() {
+                if constexpr (CacheValue) {
+                    return this->CachedValue();
+                } else {
+                    return *Iterator_;
+                }
             }
-            TValue operator*() const {
-                return *Iterator_;
+            constexpr TValue operator*() const {
+                if constexpr (CacheValue) {
+                    return this->CachedValue();
+                } else {
+                    return *Iterator_;
+                }
             }
-            void operator++() {
+            constexpr TScalarIterator& operator++() {
                 do {
                     ++Iterator_;
                     if (!(Iterator_ != std::end(*Container_))) {
                         NotFinished = false;
-                        return;
+                        return *this;
                     }
-                } while (!(*Condition_)(*Iterator_));
+                } while (!IsAccepted());
+                return *this;
             }
-            bool operator!=(const TSentinel& other) const {
+            constexpr TScalarIterator& operator--() {
+                static_assert(Bidirectional);
+                NotFinished = true;
+                do {
+                    --Iterator_;
+                } while (!IsAccepted());
+                return *this;
+            }
+            constexpr bool IsAccepted() {
+                if constexpr (CacheValue) {
+                    this->Cache(*Iterator_);
+                    return (*Condition_)(this->CachedValue());
+                } else {
+                    return (*Condition_)(*Iterator_);
+                }
+            }
+            constexpr bool operator!=(const TSentinel& other) const {
                 if (other.NotFinished) {
                     return Iterator_ != other.Iterator_;
                 } else {
                     return NotFinished;
                 }
             }
-            bool operator==(const TSentinel& other) const {
+            constexpr bool operator==(const TSentinel& other) const {
                 return !(*this != other);
             }
 
             bool NotFinished;
             TIteratorState Iterator_;
-            std::remove_reference_t<TContainer>* Container_;
-            std::remove_reference_t<TCondition>* Condition_;
+            TContainerPtr Container_;
+            TConditionPtr Condition_;
         };
     public:
         using iterator = TIterator;
         using const_iterator = TIterator;
 
-        TIterator begin() const {
-            auto first = std::begin(*Storage_.Ptr());
-            while (first != std::end(*Storage_.Ptr()) && !(*Condition_.Ptr())(*first)) {
-                ++first;
-            }
-            if (first != std::end(*Storage_.Ptr())) {
-                return {true, first, Storage_.Ptr(), Condition_.Ptr()};
+        constexpr TIterator begin() const {
+            if constexpr (BlockMask) {
+                auto data = std::data(*Storage_.Ptr());
+                const std::ptrdiff_t size = std::end(*Storage_.Ptr()) - std::begin(*Storage_.Ptr());
+                if (!size) {
+                    return {data, data, data, 0, 0, Condition_.Ptr()};
+                }
+                const TBlockMask mask = CalcBlockMask(data, std::min(size, BlockMaskSize), *Condition_.Ptr());
+                TBlockIterator first{data, data, data + size, mask, mask, Condition_.Ptr()};
+                first.SkipEmptyBlocks();
+                return first;
             } else {
-                return {false, first, Storage_.Ptr(), Condition_.Ptr()};
+                return ScalarBegin();
             }
         }
 
-        TSentinel end() const {
-            if constexpr (TrivialSentinel) {
-                return TIterator{false, std::end(*Storage_.Ptr()), Storage_.Ptr(), Condition_.Ptr()};
+        constexpr TSentinel end() const {
+            if constexpr (BlockMask) {
+                auto data = std::data(*Storage_.Ptr());
+                auto last = data + (std::end(*Storage_.Ptr()) - std::begin(*Storage_.Ptr()));
+                return {data, last, last, 0, 0, Condition_.Ptr()};
+            } else if constexpr (TrivialSentinel) {
+                return TIterator{{}, false, std::end(*Storage_.Ptr()), Storage_.Ptr(), Condition_.Ptr()};
             } else {
                 return TSentinel{std::end(*Storage_.Ptr())};
             }
         }
 
-        mutable TConditionStorage Condition_;
-        mutable TContainerStorage Storage_;
+        //! Not more than the input has
+        TSizeHint SizeHint() const {
+            return ::SizeHint(*Storage_.Ptr()).AsUpperBound();
+        }
+
+        template <typename TFunction>
+        void ForEach(TFunction&& fn) const {
+            auto& condition = *Condition_.Ptr();
+            if constexpr (BlockMask) {
+                auto data = std::data(*Storage_.Ptr());
+                const std::ptrdiff_t size = std::end(*Storage_.Ptr()) - std::begin(*Storage_.Ptr());
+                for (std::ptrdiff_t blockStart = 0; blockStart < size; blockStart += BlockMaskSize) {
+                    auto block = data + blockStart;
+                    for (auto mask = CalcBlockMask(block, std::min(size - blockStart, BlockMaskSize), condition); mask; mask &= mask - 1) {
+                        fn(block[LowestBit(mask)]);
+                    }
+                }
+            } else {
+                ::ForEach(*Storage_.Ptr(), [&fn, &condition](auto&& x) {
+                    if (condition(x)) {
+                        fn(std::forward<decltype(x)>(x));
+                    }
+                });
+            }
+        }
+
+        //! Accepted rows of the input block are marked in its selection vector
+        auto BlockReader() const {
+            return TFilterBlockReader<decltype(::BlockReader(*Storage_.Ptr())), std::remove_pointer_t<TConditionPtr>>{
+                ::BlockReader(*Storage_.Ptr()), Condition_.Ptr()};
+        }
+
+        TConditionStorage Condition_;
+        TContainerStorage Storage_;
+
+    private:
+        constexpr TScalarIterator ScalarBegin() const {
+            TScalarIterator first{{}, true, std::begin(*Storage_.Ptr()), Storage_.Ptr(), Condition_.Ptr()};
+            while (first.Iterator_ != std::end(*Storage_.Ptr()) && !first.IsAccepted()) {
+                ++first.Iterator_;
+            }
+            first.NotFinished = first.Iterator_ != std::end(*Storage_.Ptr());
+            return first;
+        }
     };
 
 }
 
 template <typename TContainerOrRef, typename TConditionOrRef>
-auto Filter(TConditionOrRef&& condition, TContainerOrRef&& container) {
+constexpr auto Filter(TConditionOrRef&& condition, TContainerOrRef&& container) {
     return NPrivate::TFilterer<TContainerOrRef, TConditionOrRef>{
             std::forward<TConditionOrRef>(condition), std::forward<TContainerOrRef>(container)};
 }
 
+//! Filter for pure predicates (no state, no side effects) over contiguous arithmetic containers:
+//! predicate is evaluated without branches over blocks of BlockMaskSize elements ahead of iteration,
+//! other containers are filtered as by Filter.
+//! Usage: for (auto x : FilterBlockMask([](i32 x) { return x > 0; }, a)) {...}
+template <typename TContainerOrRef, typename TConditionOrRef>
+constexpr auto FilterBlockMask(TConditionOrRef&& condition, TContainerOrRef&& container) {
+    return NPrivate::TFilterer<TContainerOrRef, TConditionOrRef, true>{
+            std::forward<TConditionOrRef>(condition), std::forward<TContainerOrRef>(container)};
+}
+
 
 
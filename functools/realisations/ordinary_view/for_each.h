@@ -0,0 +1,48 @@
+#pragma once
+
+#include "static_extent.h"
+#include "traits.h"
+
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+
+namespace NPrivate {
+
+    template <typename TContainer, typename TFunction>
+    static constexpr bool HasForEach(int32_t, decltype(std::declval<TContainer&>().ForEach(std::declval<TFunction&>()))*) {
+        return true;
+    }
+
+    template <typename TContainer, typename TFunction>
+    static constexpr bool HasForEach(char, std::nullptr_t*) {
+        return false;
+    }
+
+    //! Loop over a small static extent is written out, so there is no loop at all even without optimization
+    template <typename TContainer, typename TFunction, std::size_t... I>
+    constexpr void ForEachUnrolled(TContainer& container, TFunction& fn, std::index_sequence<I...>) {
+        const auto first = std::begin(container);
+        (fn(*(first + std::ptrdiff_t(I))), ...);
+    }
+
+}
+
+//! Push-based (internal) iteration: calls fn(x) for every x that `for (auto&& x : container)` would visit.
+//! Adaptors implement member ForEach with their own tight loops (e.g. Concatenate is just back-to-back loops),
+//! any other container is iterated in the ordinary way.
+//! Usage: ForEach(Zip(a, b), [&](auto t) { auto [ai, bi] = t; ... });
+template <typename TContainerOrRef, typename TFunction>
+void ForEach(TContainerOrRef&& container, TFunction&& fn) {
+    constexpr std::size_t extent = NPrivate::StaticExtent<TContainerOrRef>();
+    if constexpr (extent <= NPrivate::UnrollExtent && NPrivate::HasRandomAccessRange<TContainerOrRef>()) {
+        NPrivate::ForEachUnrolled(container, fn, std::make_index_sequence<extent>{});
+    } else if constexpr (NPrivate::HasForEach<TContainerOrRef, TFunction>((int32_t)0, nullptr)) {
+        container.ForEach(fn);
+    } else {
+        for (auto&& x : container) {
+            fn(std::forward<decltype(x)>(x));
+        }
+    }
+}
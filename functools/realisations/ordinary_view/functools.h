@@ -1,42 +1,84 @@
 #pragma once
 
+#include "block.h"
 #include "cartesian_product.h"
+#include "cartesian_product_tiled.h"
+#include "chunks.h"
 #include "concatenate.h"
+#include "copy_if.h"
 #include "enumerate.h"
 #include "filtering.h"
+#include "for_each.h"
 #include "mapped.h"
+#include "materialize.h"
+#include "parallel.h"
+#include "pipe.h"
+#include "reduce.h"
+#include "segmented.h"
+#include "size_hint.h"
+#include "slice.h"
+#include "to_array.h"
 #include "zip.h"
 
 #include <util/generic/adaptor.h>
 #include <util/generic/xrange.h>
 
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <algorithm>
 
 
 namespace NFuncToolsPrivate {
 
-    struct TTupleRecursiveFlattener {
+    //! Element of a nested tuple: its type in the flat tuple and indexes to get it
+    template <typename TLeaf, typename TPath>
+    struct TFlattenLeaf {
+    };
+
+    template <typename... TLeaves>
+    struct TFlattenLeaves {
+        template <typename... TOther>
+        TFlattenLeaves<TLeaves..., TOther...> operator+(TFlattenLeaves<TOther...>) const;
+    };
+
+    //! Leaves of TObject which is placed at TPath; objects with std::tuple_size are expanded
+    template <typename TObject, typename TPath, typename = void>
+    struct TFlattenLeavesOf {
+        using TType = TFlattenLeaves<TFlattenLeaf<TObject, TPath>>;
+    };
+
+    template <typename TObject, std::size_t... Path>
+    struct TFlattenLeavesOf<TObject, std::index_sequence<Path...>, std::void_t<decltype(std::tuple_size<std::decay_t<TObject>>::value)>> {
+        template <std::size_t... I>
+        static auto Expand(std::index_sequence<I...>) -> decltype((TFlattenLeaves<>{} + ... +
+            typename TFlattenLeavesOf<std::tuple_element_t<I, std::decay_t<TObject>>, std::index_sequence<Path..., I>>::TType{}));
+
+        using TType = decltype(Expand(std::make_index_sequence<std::tuple_size<std::decay_t<TObject>>::value>{}));
+    };
 
-        template <class TObject, std::size_t... I>
-        static auto FlattenTuple(TObject&& object, std::index_sequence<I...>) {
-            return std::tuple_cat(Flatten(std::forward<std::tuple_element_t<I, std::decay_t<TObject>>>(std::get<I>(object)), 0u)...);
+    //! Flat tuple is built at once from compile-time paths of leaves, no intermediate tuples.
+    //! References stay references, values are moved out of temporaries and copied otherwise
+    struct TTupleFlattener {
+
+        template <class TObject>
+        static constexpr TObject&& Get(TObject&& object, std::index_sequence<>) {
+            return std::forward<TObject>(object);
         }
 
-        template <class TObject, size_t Size = std::tuple_size<std::decay_t<TObject>>::value>
-        static auto Flatten(TObject&& object, uint32_t) {
-            auto indexes = std::make_index_sequence<Size>{};
-            return FlattenTuple(std::forward<TObject>(object), indexes);
+        template <class TObject, std::size_t I, std::size_t... Rest>
+        static constexpr decltype(auto) Get(TObject&& object, std::index_sequence<I, Rest...>) {
+            return Get(std::get<I>(std::forward<TObject>(object)), std::index_sequence<Rest...>{});
         }
 
-        template <class TObject>
-        static auto Flatten(TObject&& object, char) {
-            return std::tuple<TObject>(std::forward<TObject>(object));
+        template <class TObject, class... TLeafTypes, class... TPaths>
+        static constexpr auto Build(TObject&& object, TFlattenLeaves<TFlattenLeaf<TLeafTypes, TPaths>...>) {
+            return std::tuple<TLeafTypes...>(Get(std::forward<TObject>(object), TPaths{})...);
         }
 
         template <class TObject>
-        auto operator()(TObject&& object) const {
-            return Flatten(std::forward<TObject>(object), 0u);
+        constexpr auto operator()(TObject&& object) const {
+            return Build(std::forward<TObject>(object), typename TFlattenLeavesOf<TObject, std::index_sequence<>>::TType{});
         }
 
     };
@@ -45,42 +87,78 @@ namespace NFuncToolsPrivate {
 namespace NFuncTools {
     using ::Enumerate;
     using ::Filter;
+    using ::FilterBlockMask;
     using ::Reversed;
     using ::Zip;
+    using ::ZipEqual;
     using ::Concatenate;
     using ::CartesianProduct;
+    using ::CartesianProductTiled;
+    using ::Chunks;
+    using ::ForEach;
+    using ::ForEachBlock;
+    using ::BlockReader;
+    using ::Accumulate;
+    using ::Copy;
+    using ::Count;
+    using ::Find;
+    using ::ParallelForEach;
+    using ::Reduce;
+    using ::Sum;
+    using ::Min;
+    using ::Max;
+    using ::FilterInto;
+    using ::CopyIf;
+    using ::SizeHint;
+    using ::Materialize;
+    using ::Slice;
+    using ::ToArray;
 
     template <typename TValue>
-    auto Range(TValue from, TValue to, TValue step) {
+    constexpr auto Range(TValue from, TValue to, TValue step) {
         return xrange(from, to, step);
     }
 
     template <typename TValue>
-    auto Range(TValue from, TValue to) {
+    constexpr auto Range(TValue from, TValue to) {
         return xrange(from, to);
     }
 
+    //! Step is known at compile time
+    //! Usage: for (auto i : Range<4>(0, n)) {...}
+    template <auto Step, typename TValue>
+    constexpr auto Range(TValue from, TValue to) {
+        return xrange<Step>(from, to);
+    }
+
     template <typename TValue>
-    auto Range(TValue to) {
+    constexpr auto Range(TValue to) {
         return xrange(to);
     }
 
     //! Usage: for (i32 x : Map([](i32 x) { return x * x; }, a)) {...}
     template <typename TMapper, typename TContainerOrRef>
-    auto Map(TMapper&& mapper, TContainerOrRef&& container) {
+    constexpr auto Map(TMapper&& mapper, TContainerOrRef&& container) {
         return ::MakeMappedRange(std::forward<TContainerOrRef>(container), std::forward<TMapper>(mapper));
     }
 
     //! Usage: for (auto i : Map<int>(floats)) {...}
     template <typename TMapResult, typename TContainerOrRef>
-    auto Map(TContainerOrRef&& container) {
+    constexpr auto Map(TContainerOrRef&& container) {
         return Map([](const auto& x) { return TMapResult(x); }, std::forward<TContainerOrRef>(container));
     }
 
+    //! Pipe stage, Map(g) right after Map(f) is fused into one Map
+    //! Usage: auto sum = a | Map([](i32 x) { return x * x; }) | Filter(predicate) | Sum();
+    template <typename TMapper>
+    constexpr auto Map(TMapper&& mapper) {
+        return ::NPrivate::TMapStage<TMapper>{std::forward<TMapper>(mapper)};
+    }
+
     //! Usage: for (auto [i, ai, bi] : Flatten(Enumerate(Zip(a, b))) {...}
     template <typename TContainerOrRef>
-    auto Flatten(TContainerOrRef&& container) {
-        return Map(NFuncToolsPrivate::TTupleRecursiveFlattener{}, std::forward<TContainerOrRef>(container));
+    constexpr auto Flatten(TContainerOrRef&& container) {
+        return Map(NFuncToolsPrivate::TTupleFlattener{}, std::forward<TContainerOrRef>(container));
     }
 
 }
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+/** @file
+ * Minimal tuple for the state of adaptors (holders of containers, iterators of Zip and CartesianProduct).
+ * It has one base per element, so Get<I> is a single overload resolution
+ * instead of the recursive instantiations of std::tuple.
+ * Usage: TLightTuple<int, char*> state{1, p}; Get<1>(state) = nullptr;
+ */
+
+namespace NPrivate {
+
+    template <std::size_t Index, typename T>
+    struct TLightTupleLeaf {
+        TLightTupleLeaf() = default;
+
+        //! Direct initialization as in std::tuple: types with a template conversion operator (e.g. xrange) are not converted
+        template <typename TArg>
+        constexpr TLightTupleLeaf(std::in_place_t, TArg&& arg)
+            : Value_(std::forward<TArg>(arg))
+        {
+        }
+
+        T Value_;
+    };
+
+    template <typename TIndexes, typename... Ts>
+    struct TLightTupleImpl;
+
+    template <std::size_t... I, typename... Ts>
+    struct TLightTupleImpl<std::index_sequence<I...>, Ts...> : TLightTupleLeaf<I, Ts>... {
+        TLightTupleImpl() = default;
+
+        template <typename... TArgs, typename = std::enable_if_t<sizeof...(TArgs) == sizeof...(Ts) &&
+            !(sizeof...(TArgs) == 1 && (std::is_same_v<std::decay_t<TArgs>, TLightTupleImpl> && ...))>>
+        constexpr TLightTupleImpl(TArgs&&... args)
+            : TLightTupleLeaf<I, Ts>(std::in_place, std::forward<TArgs>(args))...
+        {
+        }
+
+        //! Conversion on request, e.g. for std::apply
+        std::tuple<Ts...> ToTuple() const {
+            return std::tuple<Ts...>(static_cast<const TLightTupleLeaf<I, Ts>&>(*this).Value_...);
+        }
+    };
+
+    template <typename... Ts>
+    using TLightTuple = TLightTupleImpl<std::index_sequence_for<Ts...>, Ts...>;
+
+    //! T is deduced from the only base with the index
+    template <std::size_t Index, typename T>
+    constexpr T& Get(TLightTupleLeaf<Index, T>& leaf) {
+        return leaf.Value_;
+    }
+
+    template <std::size_t Index, typename T>
+    constexpr const T& Get(const TLightTupleLeaf<Index, T>& leaf) {
+        return leaf.Value_;
+    }
+
+    template <std::size_t Index, typename T>
+    constexpr T&& Get(TLightTupleLeaf<Index, T>&& leaf) {
+        return std::forward<T>(leaf.Value_);
+    }
+
+    //! For structured bindings
+    template <std::size_t Index, typename T>
+    constexpr T& get(TLightTupleLeaf<Index, T>& leaf) {
+        return leaf.Value_;
+    }
+
+    template <std::size_t Index, typename T>
+    constexpr const T& get(const TLightTupleLeaf<Index, T>& leaf) {
+        return leaf.Value_;
+    }
+
+    template <std::size_t Index, typename T>
+    constexpr T&& get(TLightTupleLeaf<Index, T>&& leaf) {
+        return std::forward<T>(leaf.Value_);
+    }
+
+    template <std::size_t Index, typename T>
+    T LightTupleElement(const TLightTupleLeaf<Index, T>&);
+
+}
+
+namespace std {
+    template <typename TIndexes, typename... Ts>
+    struct tuple_size<NPrivate::TLightTupleImpl<TIndexes, Ts...>> : integral_constant<size_t, sizeof...(Ts)> {
+    };
+
+    template <size_t Index, typename TIndexes, typename... Ts>
+    struct tuple_element<Index, NPrivate::TLightTupleImpl<TIndexes, Ts...>> {
+        using type = decltype(NPrivate::LightTupleElement<Index>(declval<const NPrivate::TLightTupleImpl<TIndexes, Ts...>&>()));
+    };
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "block.h"
+#include "for_each.h"
+#include "size_hint.h"
+#include "static_extent.h"
+
 #include <util/generic/iterator_range.h>
 #include <util/generic/store_policy.h>
 
@@ -12,6 +17,23 @@ namespace NPrivate {
         return std::is_same_v<typename std::iterator_traits<TIterator>::iterator_category,
                               std::random_access_iterator_tag>;
     }
+
+    //! Same as std::reference_wrapper, which is constexpr only since C++20
+    template <class TMapper>
+    struct TMapperRef {
+        TMapper* Mapper_;
+
+        template <class... TArgs>
+        constexpr decltype(auto) operator()(TArgs&&... args) const {
+            return (*Mapper_)(std::forward<TArgs>(args)...);
+        }
+    };
+
+    template <class TIterator>
+    constexpr bool HasBidirectional() {
+        return std::is_base_of_v<std::bidirectional_iterator_tag,
+                                 typename std::iterator_traits<TIterator>::iterator_category>;
+    }
 };
 
 
@@ -22,65 +44,70 @@ class TMappedIterator {
     using TValue = decltype(std::declval<TMapper>()(std::declval<TSrcPointerType>()));
 public:
     using difference_type = std::ptrdiff_t;
-    using value_type = TValue;
-    using reference = TValue&;
+    using value_type = std::decay_t<TValue>;
+    using reference = TValue;
     using pointer = std::remove_reference_t<TValue>*;
 
-    using iterator_category = std::conditional_t<NPrivate::HasRandomAccess<TIterator>(),
-        std::random_access_iterator_tag, std::input_iterator_tag>;
+    using iterator_category = std::conditional_t<NPrivate::HasRandomAccess<TIterator>(), std::random_access_iterator_tag,
+        std::conditional_t<NPrivate::HasBidirectional<TIterator>(), std::bidirectional_iterator_tag, std::input_iterator_tag>>;
 
-    TMappedIterator(TIterator it, TMapper mapper)
+    constexpr TMappedIterator(TIterator it, TMapper mapper)
         : Iter(it)
         , Mapper(mapper)
     {
     }
 
-    TSelf& operator++() {
+    constexpr TSelf& operator++() {
         ++Iter;
         return *this;
     }
-    TSelf& operator--() {
+    constexpr TSelf& operator--() {
         --Iter;
         return *this;
     }
-    TValue operator*() {
+    constexpr TSelf operator--(int) {
+        TSelf result = *this;
+        --Iter;
+        return result;
+    }
+    constexpr TValue operator*() {
         return Mapper((*Iter));
     }
-    TValue operator*() const {
+    constexpr TValue operator*() const {
         return Mapper((*Iter));
     }
 
-    pointer operator->() const {
+    constexpr pointer operator->() const {
         return &(Mapper((*Iter)));
     }
 
-    TValue operator[](difference_type n) const {
+    constexpr TValue operator[](difference_type n) const {
         return Mapper(*(Iter + n));
     }
-    TSelf& operator+=(difference_type n) {
+    constexpr TSelf& operator+=(difference_type n) {
         Iter += n;
         return *this;
     }
-    TSelf& operator-=(difference_type n) {
+    constexpr TSelf& operator-=(difference_type n) {
         Iter -= n;
         return *this;
     }
-    TSelf operator+(difference_type n) const {
+    constexpr TSelf operator+(difference_type n) const {
         return TSelf(Iter + n, Mapper);
     }
-    difference_type operator-(const TSelf& other) const {
+    constexpr difference_type operator-(const TSelf& other) const {
         return Iter - other.Iter;
     }
-    bool operator==(const TSelf& other) const {
+    constexpr bool operator==(const TSelf& other) const {
         return Iter == other.Iter;
     }
-    bool operator!=(const TSelf& other) const {
+    constexpr bool operator!=(const TSelf& other) const {
         return Iter != other.Iter;
     }
-    bool operator>(const TSelf& other) const {
+    constexpr bool operator>(const TSelf& other) const {
         return Iter > other.Iter;
     }
-    bool operator<(const TSelf& other) const {
+    constexpr bool operator<(const TSelf& other) const {
         return Iter < other.Iter;
     }
 
@@ -93,10 +120,13 @@ private:
 template <class TContainer, class TMapper>
 class TInputMappedRange {
 protected:
-    using TContainerStorage = TAutoEmbedOrPtrPolicy<TContainer>;
-    using TMapperStorage = TAutoEmbedOrPtrPolicy<TMapper>;
-    using TMapperWrapper = std::reference_wrapper<std::remove_reference_t<TMapper>>;
     using InternalIterator = decltype(std::begin(std::declval<TContainer&>()));
+    using TContainerStorage = TAutoEmbedOrPtrPolicy<TContainer>;
+    //! Mapper held by value is const if it can be called as const, so Map stays constexpr
+    using TMapperStorage = TAutoEmbedOrPtrPolicy<TMapper, std::is_reference_v<TMapper>,
+        std::is_invocable_v<const std::remove_reference_t<TMapper>&, typename std::iterator_traits<InternalIterator>::reference>>;
+    using TMapperObject = std::remove_pointer_t<decltype(std::declval<const TMapperStorage&>().Ptr())>;
+    using TMapperWrapper = NPrivate::TMapperRef<TMapperObject>;
     using Iterator = TMappedIterator<InternalIterator, TMapperWrapper>;
 public:
     using iterator = Iterator;
@@ -105,23 +135,61 @@ public:
     using reference = typename std::iterator_traits<iterator>::reference;
     using const_reference = typename std::iterator_traits<const_iterator>::reference;
 
-    TInputMappedRange(TContainer&& container, TMapper&& mapper)
+    //! Number of elements if it is known at compile time (std::array, C array)
+    static constexpr std::size_t Extent = NPrivate::StaticExtent<TContainer>();
+
+    constexpr TInputMappedRange(TContainer&& container, TMapper&& mapper)
         : Container(std::forward<TContainer>(container))
         , Mapper(std::forward<TMapper>(mapper))
     {
     }
 
-    Iterator begin() const {
-        return {std::begin(*Container.Ptr()), {*Mapper.Ptr()}};
+    constexpr Iterator begin() const {
+        return {std::begin(*Container.Ptr()), {Mapper.Ptr()}};
+    }
+
+    constexpr Iterator end() const {
+        return {std::end(*Container.Ptr()), {Mapper.Ptr()}};
+    }
+
+    TSizeHint SizeHint() const {
+        return ::SizeHint(*Container.Ptr());
+    }
+
+    //! Mapper is applied to the whole block of the input
+    auto BlockReader() const {
+        return NPrivate::TMapBlockReader<decltype(::BlockReader(*Container.Ptr())), TMapperObject>{
+            ::BlockReader(*Container.Ptr()), Mapper.Ptr(), {}};
+    }
+
+    //! Input and mapper, so pipe.h can fuse a | Map(f) | Map(g) into one Map
+    constexpr TContainerStorage& SourceStorage() {
+        return Container;
+    }
+
+    constexpr const TContainerStorage& SourceStorage() const {
+        return Container;
+    }
+
+    constexpr TMapperStorage& MapperStorage() {
+        return Mapper;
+    }
+
+    constexpr const TMapperStorage& MapperStorage() const {
+        return Mapper;
     }
 
-    Iterator end() const {
-        return {std::end(*Container.Ptr()), {*Mapper.Ptr()}};
+    template <typename TFunction>
+    void ForEach(TFunction&& fn) const {
+        auto& mapper = *Mapper.Ptr();
+        ::ForEach(*Container.Ptr(), [&fn, &mapper](auto&& x) {
+            fn(mapper(std::forward<decltype(x)>(x)));
+        });
     }
 
 protected:
-    mutable TContainerStorage Container;
-    mutable TMapperStorage Mapper;
+    TContainerStorage Container;
+    TMapperStorage Mapper;
 };
 
 
@@ -140,7 +208,7 @@ public:
     using difference_type = typename std::iterator_traits<iterator>::difference_type;
     using size_type = std::size_t;
 
-    TRandomAccessMappedRange(TContainer&& container, TMapper&& mapper)
+    constexpr TRandomAccessMappedRange(TContainer&& container, TMapper&& mapper)
         : TBase(std::forward<TContainer>(container), std::forward<TMapper>(mapper))
     {
     }
@@ -148,21 +216,21 @@ public:
     using TBase::begin;
     using TBase::end;
 
-    bool empty() const {
+    constexpr bool empty() const {
         return std::end(*this->Container.Ptr()) == std::begin(*this->Container.Ptr());
     }
 
-    size_type size() const {
+    constexpr size_type size() const {
         return std::end(*this->Container.Ptr()) - std::begin(*this->Container.Ptr());
     }
 
-    const_reference operator[](size_t at) const {
+    constexpr const_reference operator[](size_t at) const {
         Y_ASSERT(at < this->size());
 
         return *(this->begin() + at);
     }
 
-    reference operator[](size_t at) {
+    constexpr reference operator[](size_t at) {
         Y_ASSERT(at < this->size());
 
         return *(this->begin() + at);
@@ -170,17 +238,17 @@ public:
 };
 
 template <class TIterator, class TMapper>
-TMappedIterator<TIterator, TMapper> MakeMappedIterator(TIterator iter, TMapper mapper) {
+constexpr TMappedIterator<TIterator, TMapper> MakeMappedIterator(TIterator iter, TMapper mapper) {
     return {iter, mapper};
 }
 
 template <class TIterator, class TMapper>
-auto MakeMappedRange(TIterator begin, TIterator end, TMapper mapper) {
+constexpr auto MakeMappedRange(TIterator begin, TIterator end, TMapper mapper) {
     return MakeIteratorRange(MakeMappedIterator(begin, mapper), MakeMappedIterator(end, mapper));
 }
 
 template <class TContainer, class TMapper>
-auto MakeMappedRange(TContainer&& container, TMapper&& mapper) {
+constexpr auto MakeMappedRange(TContainer&& container, TMapper&& mapper) {
     if constexpr (NPrivate::HasRandomAccess<decltype(std::begin(container))>()) {
         return TRandomAccessMappedRange<TContainer, TMapper>(std::forward<TContainer>(container), std::forward<TMapper>(mapper));
     } else {
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "for_each.h"
+#include "segmented.h"
+#include "size_hint.h"
+#include "zip.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+
+namespace NPrivate {
+
+    //! Element of materialized range: tuples of references become tuples of values
+    template <typename TValue>
+    struct TMaterializedValue {
+        using TType = std::decay_t<TValue>;
+    };
+
+    template <typename... TValues>
+    struct TMaterializedValue<std::tuple<TValues...>> {
+        using TType = std::tuple<std::decay_t<TValues>...>;
+    };
+
+    template <typename... TValues>
+    struct TMaterializedValue<TZipReference<TValues...>> {
+        using TType = std::tuple<std::decay_t<TValues>...>;
+    };
+
+    //! Source is an array of trivially copyable elements of the same type as the result has
+    template <typename TResult, typename TContainer>
+    static constexpr bool CanCopyBytes(int32_t, decltype(std::data(std::declval<TContainer&>()))*, decltype(std::declval<TResult&>().data())*) {
+        using TData = decltype(std::data(std::declval<TContainer&>()));
+        using TElement = std::remove_cv_t<std::remove_pointer_t<TData>>;
+        return std::is_pointer_v<TData> && std::is_trivially_copyable_v<TElement> &&
+            std::is_same_v<TElement, typename TResult::value_type> && HasSize<TContainer>(0);
+    }
+
+    template <typename TResult, typename TContainer>
+    static constexpr bool CanCopyBytes(char, std::nullptr_t*, std::nullptr_t*) {
+        return false;
+    }
+
+    template <typename TResult>
+    static constexpr bool HasReserve(int32_t, decltype(std::declval<TResult&>().reserve(0))*) {
+        return true;
+    }
+
+    template <typename TResult>
+    static constexpr bool HasReserve(char, std::nullptr_t*) {
+        return false;
+    }
+
+}
+
+//! Collects the range into a container, memory is reserved once if the size of the range is known exactly
+//! Arrays of trivially copyable elements are copied by memcpy, segments of Concatenate by bulk inserts
+//! Default container is std::vector of elements (tuples of values for Zip, Enumerate, ...)
+//! Usage: auto squares = Materialize(Map([](int x) { return x * x; }, a));
+//!        auto unique = Materialize<std::set<int>>(Concatenate(a, b));
+template <typename TResult = void, typename TContainerOrRef>
+auto Materialize(TContainerOrRef&& container) {
+    using TValue = typename NPrivate::TMaterializedValue<decltype(*std::begin(container))>::TType;
+    using TContainer = std::conditional_t<std::is_void_v<TResult>, std::vector<TValue>, TResult>;
+
+    TContainer result;
+    if constexpr (NPrivate::CanCopyBytes<TContainer, std::remove_reference_t<TContainerOrRef>>((int32_t)0, nullptr, nullptr)) {
+        const std::size_t size = std::size(container);
+        result.resize(size);
+        if (size) {
+            std::memcpy(result.data(), std::data(container), size * sizeof(typename TContainer::value_type));
+        }
+    } else {
+        if constexpr (NPrivate::HasReserve<TContainer>((int32_t)0, nullptr)) {
+            // upper bounds (e.g. of Filter) may be far above the real size, the container grows as usual then
+            if (const TSizeHint hint = ::SizeHint(container); hint.IsExact()) {
+                result.reserve(hint.Size);
+            }
+        }
+        if constexpr (NPrivate::IsSegmented<TContainerOrRef>((int32_t)0, nullptr) &&
+                      NPrivate::HasReserve<TContainer>((int32_t)0, nullptr)) {
+            std::apply([&result](const auto&... segments) {
+                (result.insert(result.end(), segments.begin(), segments.end()), ...);
+            }, container.Segments());
+        } else {
+            ::ForEach(container, [&result](auto&& x) {
+                result.insert(result.end(), std::forward<decltype(x)>(x));
+            });
+        }
+    }
+    return result;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "for_each.h"
+#include "thread_pool.h"
+#include "traits.h"
+
+#include <iterator>
+
+
+//! Calls fn(x) for every x of the range on several threads of the pool, fn must be thread-safe
+//! Random access ranges (Range, Map over vectors, Zip, Enumerate, CartesianProduct, ...) are split by indexes,
+//! each thread iterates its part from `begin() + offset`, so e.g. indexes of Enumerate are the global ones.
+//! Other ranges are processed by ForEach in the calling thread.
+//! Zero threads means one thread per core, zero grain (elements per task) is chosen by size
+//! Usage: ParallelForEach(Zip(a, b), [&](auto t) { auto [ai, bi] = t; ... });
+template <typename TContainerOrRef, typename TFunction>
+void ParallelForEach(TContainerOrRef&& container, TFunction&& fn, std::size_t threads = 0, std::size_t grain = 0) {
+    if constexpr (NPrivate::HasRandomAccessRange<TContainerOrRef>()) {
+        const auto first = std::begin(container);
+        const std::ptrdiff_t size = std::end(container) - first;
+        NPrivate::ParallelFor(size, threads, grain, [&first, &fn](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            auto it = first + begin;
+            for (std::ptrdiff_t j = begin; j < end; ++j, ++it) {
+                fn(*it);
+            }
+        });
+    } else {
+        ::ForEach(container, fn);
+    }
+}
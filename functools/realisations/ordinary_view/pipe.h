@@ -0,0 +1,240 @@
+#pragma once
+
+#include "enumerate.h"
+#include "filtering.h"
+#include "mapped.h"
+#include "materialize.h"
+#include "reduce.h"
+
+#include <util/generic/adaptor.h>
+
+#include <type_traits>
+#include <utility>
+
+
+/** @file
+ * Pipe composition: a | Map(f) | Filter(p) | Sum().
+ * Every stage builds the adaptor object right away (no iterators are created until begin()),
+ * and looks at the adaptor on its left first, so chains are rewritten at compile time:
+ * Map(g) over Map(f, a) is Map(g . f, a), Filter(q) over Filter(p, a) is Filter(p && q, a),
+ * Reversed() over Reversed(a) is a itself.
+ */
+
+namespace NPrivate {
+
+    template <typename TMapper>
+    struct TMapStage {
+        TMapper Mapper_;
+    };
+
+    template <typename TCondition>
+    struct TFilterStage {
+        TCondition Condition_;
+    };
+
+    struct TReversedStage {
+    };
+
+    struct TEnumerateStage {
+    };
+
+    struct TSumStage {
+    };
+
+    struct TMinStage {
+    };
+
+    struct TMaxStage {
+    };
+
+    template <typename TResult>
+    struct TMaterializeStage {
+    };
+
+    template <typename TRange>
+    struct TMappedRangeParts {
+        static constexpr bool IsMapped = false;
+    };
+
+    template <typename TContainer_, typename TMapper_>
+    struct TMappedRangeParts<TInputMappedRange<TContainer_, TMapper_>> {
+        static constexpr bool IsMapped = true;
+        using TContainer = TContainer_;
+        using TMapper = TMapper_;
+    };
+
+    template <typename TContainer, typename TMapper>
+    struct TMappedRangeParts<TRandomAccessMappedRange<TContainer, TMapper>> : TMappedRangeParts<TInputMappedRange<TContainer, TMapper>> {
+    };
+
+    template <typename TRange>
+    struct TFiltererParts {
+        static constexpr bool IsFilterer = false;
+    };
+
+    template <typename TContainer_, typename TCondition_>
+    struct TFiltererParts<TFilterer<TContainer_, TCondition_>> {
+        static constexpr bool IsFilterer = true;
+        using TContainer = TContainer_;
+        using TCondition = TCondition_;
+    };
+
+    template <typename TRange>
+    struct TReverseRangeParts {
+        static constexpr bool IsReversed = false;
+    };
+
+    template <typename TRange_>
+    struct TReverseRangeParts<TReverseRange<TRange_>> {
+        static constexpr bool IsReversed = true;
+        using TRange = TRange_;
+    };
+
+    //! Type in which a part of a rewritten adaptor is passed on:
+    //! embedded parts of a temporary adaptor are moved out, others are referenced as the storage gives them
+    template <typename TStored, bool FromTemporary, typename TStorage>
+    using TTakenPart = std::conditional_t<FromTemporary && !std::is_reference_v<TStored>,
+        TStored, decltype(*std::declval<TStorage&>().Ptr())>;
+
+    template <typename TStored, bool FromTemporary, typename TStorage>
+    constexpr decltype(auto) TakePart(TStorage& storage) {
+        if constexpr (FromTemporary && !std::is_reference_v<TStored>) {
+            return std::move(*storage.Ptr());
+        } else {
+            return *storage.Ptr();
+        }
+    }
+
+    //! g . f, the result of f is passed to g without a copy
+    template <typename TInner, typename TOuter>
+    struct TComposedMapper {
+        TInner Inner_;
+        TOuter Outer_;
+
+        template <typename TValue>
+        constexpr decltype(auto) operator()(TValue&& value) {
+            return Outer_(Inner_(std::forward<TValue>(value)));
+        }
+    };
+
+    //! p && q, q is checked only for values accepted by p as in Filter(q, Filter(p, a))
+    template <typename TFirst, typename TSecond>
+    struct TConjunction {
+        TFirst First_;
+        TSecond Second_;
+
+        template <typename TValue>
+        constexpr bool operator()(const TValue& value) {
+            return First_(value) && Second_(value);
+        }
+    };
+
+    template <typename TRange, typename TMapper>
+    constexpr auto operator|(TRange&& range, TMapStage<TMapper> stage) {
+        using TParts = TMappedRangeParts<std::decay_t<TRange>>;
+        if constexpr (TParts::IsMapped) {
+            constexpr bool fromTemporary = !std::is_lvalue_reference_v<TRange>;
+            using TInner = TTakenPart<typename TParts::TMapper, fromTemporary, std::remove_reference_t<decltype(range.MapperStorage())>>;
+            return ::MakeMappedRange(
+                TakePart<typename TParts::TContainer, fromTemporary>(range.SourceStorage()),
+                TComposedMapper<TInner, TMapper>{
+                    TakePart<typename TParts::TMapper, fromTemporary>(range.MapperStorage()),
+                    std::forward<TMapper>(stage.Mapper_)});
+        } else {
+            return ::MakeMappedRange(std::forward<TRange>(range), std::forward<TMapper>(stage.Mapper_));
+        }
+    }
+
+    template <typename TRange, typename TCondition>
+    constexpr auto operator|(TRange&& range, TFilterStage<TCondition> stage) {
+        using TParts = TFiltererParts<std::decay_t<TRange>>;
+        if constexpr (TParts::IsFilterer) {
+            constexpr bool fromTemporary = !std::is_lvalue_reference_v<TRange>;
+            using TFirst = TTakenPart<typename TParts::TCondition, fromTemporary, std::remove_reference_t<decltype((range.Condition_))>>;
+            return ::Filter(
+                TConjunction<TFirst, TCondition>{
+                    TakePart<typename TParts::TCondition, fromTemporary>(range.Condition_),
+                    std::forward<TCondition>(stage.Condition_)},
+                TakePart<typename TParts::TContainer, fromTemporary>(range.Storage_));
+        } else {
+            return ::Filter(std::forward<TCondition>(stage.Condition_), std::forward<TRange>(range));
+        }
+    }
+
+    //! Reversed twice gives the input back: by value if it was embedded into a temporary, by reference otherwise
+    template <typename TRange>
+    constexpr decltype(auto) operator|(TRange&& range, TReversedStage) {
+        using TParts = TReverseRangeParts<std::decay_t<TRange>>;
+        if constexpr (TParts::IsReversed) {
+            using TInput = typename TParts::TRange;
+            if constexpr (!std::is_lvalue_reference_v<TRange> && !std::is_reference_v<TInput>) {
+                return TInput(std::move(range.Base()));
+            } else {
+                return range.Base();
+            }
+        } else {
+            return ::Reversed(std::forward<TRange>(range));
+        }
+    }
+
+    template <typename TRange>
+    constexpr auto operator|(TRange&& range, TEnumerateStage) {
+        return ::Enumerate(std::forward<TRange>(range));
+    }
+
+    template <typename TRange>
+    auto operator|(TRange&& range, TSumStage) {
+        return ::Sum(std::forward<TRange>(range));
+    }
+
+    template <typename TRange>
+    auto operator|(TRange&& range, TMinStage) {
+        return ::Min(std::forward<TRange>(range));
+    }
+
+    template <typename TRange>
+    auto operator|(TRange&& range, TMaxStage) {
+        return ::Max(std::forward<TRange>(range));
+    }
+
+    template <typename TRange, typename TResult>
+    auto operator|(TRange&& range, TMaterializeStage<TResult>) {
+        return ::Materialize<TResult>(std::forward<TRange>(range));
+    }
+
+}
+
+//! Usage: for (auto x : a | Filter(p)) {...}
+template <typename TConditionOrRef>
+constexpr auto Filter(TConditionOrRef&& condition) {
+    return NPrivate::TFilterStage<TConditionOrRef>{std::forward<TConditionOrRef>(condition)};
+}
+
+//! Usage: for (auto x : a | Reversed()) {...}
+constexpr NPrivate::TReversedStage Reversed() {
+    return {};
+}
+
+//! Usage: for (auto [i, x] : a | Enumerate()) {...}
+constexpr NPrivate::TEnumerateStage Enumerate() {
+    return {};
+}
+
+//! Usage: auto sum = a | Map(f) | Sum();
+inline NPrivate::TSumStage Sum() {
+    return {};
+}
+
+inline NPrivate::TMinStage Min() {
+    return {};
+}
+
+inline NPrivate::TMaxStage Max() {
+    return {};
+}
+
+//! Usage: auto v = a | Filter(p) | Materialize();
+template <typename TResult = void>
+NPrivate::TMaterializeStage<TResult> Materialize() {
+    return {};
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "for_each.h"
+#include "thread_pool.h"
+#include "traits.h"
+
+#include <util/generic/store_policy.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+
+/** @file
+ * Parallel reduction with reproducible result.
+ * Random access range is cut into blocks of fixed size (independent of number of threads),
+ * every block is folded from left to right, then block results are combined by a fixed pairwise tree.
+ * So the order of operations and therefore the floating point result do not depend on the number of threads.
+ * Ranges of one block are reduced by the same left fold in the calling thread.
+ * Other ranges are folded serially by ForEach.
+ */
+
+namespace NPrivate {
+
+    static constexpr std::ptrdiff_t ReduceBlockSize = 1 << 14;
+
+    template <typename TValue, typename TIterator, typename TBinaryOperation>
+    TValue ReduceBlock(TIterator first, std::ptrdiff_t size, TBinaryOperation& op) {
+        TValue result = *first;
+        ++first;
+        for (std::ptrdiff_t j = 1; j < size; ++j, ++first) {
+            result = op(std::move(result), *first);
+        }
+        return result;
+    }
+
+    //! partial[i] = op(partial[i], partial[i + step]) for step = 1, 2, 4, ..., the result is in partial[0]
+    template <typename TValue, typename TBinaryOperation>
+    TValue CombinePairwise(std::vector<std::optional<TValue>>& partial, TBinaryOperation& op) {
+        for (std::size_t step = 1; step < partial.size(); step *= 2) {
+            for (std::size_t i = 0; i + step < partial.size(); i += 2 * step) {
+                partial[i] = op(std::move(*partial[i]), std::move(*partial[i + step]));
+            }
+        }
+        return std::move(*partial[0]);
+    }
+
+}
+
+//! op must be associative: it combines both elements and partial results, so elements must be convertible to the type of init
+//! Zero threads means one thread per core, result is the same for any number of threads
+//! Usage: double sum = Reduce(Map([](auto t) { auto [ai, bi] = t; return ai * bi; }, Zip(a, b)), 0.0);
+template <typename TContainerOrRef, typename TValue, typename TBinaryOperation = std::plus<>>
+TValue Reduce(TContainerOrRef&& container, TValue init, TBinaryOperation op = {}, std::size_t threads = 0) {
+    if constexpr (NPrivate::HasRandomAccessRange<TContainerOrRef>()) {
+        const auto first = std::begin(container);
+        const std::ptrdiff_t size = std::end(container) - first;
+        if (size <= 0) {
+            return init;
+        }
+        const std::ptrdiff_t blockSize = NPrivate::ReduceBlockSize;
+        if (size <= blockSize) {
+            return op(std::move(init), NPrivate::ReduceBlock<TValue>(first, size, op));
+        }
+        std::vector<std::optional<TValue>> partial((size + blockSize - 1) / blockSize);
+        NPrivate::ParallelFor(std::ptrdiff_t(partial.size()), threads, 1, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            for (std::ptrdiff_t block = begin; block < end; ++block) {
+                const std::ptrdiff_t offset = block * blockSize;
+                partial[block] = NPrivate::ReduceBlock<TValue>(first + offset, std::min(blockSize, size - offset), op);
+            }
+        });
+        return op(std::move(init), NPrivate::CombinePairwise(partial, op));
+    } else {
+        ::ForEach(container, [&init, &op](auto&& x) {
+            init = op(std::move(init), std::forward<decltype(x)>(x));
+        });
+        return init;
+    }
+}
+
+//! Result has type of elements
+//! Usage: auto total = Sum(Concatenate(a, b));
+template <typename TContainerOrRef>
+auto Sum(TContainerOrRef&& container, std::size_t threads = 0) {
+    using TValue = std::decay_t<decltype(*std::begin(container))>;
+    return Reduce(std::forward<TContainerOrRef>(container), TValue{}, std::plus<>{}, threads);
+}
+
+//! The first of minimal elements, the range must not be empty
+template <typename TContainerOrRef>
+auto Min(TContainerOrRef&& container, std::size_t threads = 0) {
+    using TValue = std::decay_t<decltype(*std::begin(container))>;
+    auto first = std::begin(container);
+    Y_VERIFY(first != std::end(container));
+    TValue init = *first;
+    return Reduce(std::forward<TContainerOrRef>(container), std::move(init), [](const TValue& a, const TValue& b) {
+        return b < a ? b : a;
+    }, threads);
+}
+
+//! The first of maximal elements, the range must not be empty
+template <typename TContainerOrRef>
+auto Max(TContainerOrRef&& container, std::size_t threads = 0) {
+    using TValue = std::decay_t<decltype(*std::begin(container))>;
+    auto first = std::begin(container);
+    Y_VERIFY(first != std::end(container));
+    TValue init = *first;
+    return Reduce(std::forward<TContainerOrRef>(container), std::move(init), [](const TValue& a, const TValue& b) {
+        return a < b ? b : a;
+    }, threads);
+}
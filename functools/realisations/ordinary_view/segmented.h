@@ -0,0 +1,117 @@
+#pragma once
+
+#include "for_each.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+
+
+/** @file
+ * Algorithms aware of segmented ranges (e.g. Concatenate of several containers).
+ * Segmented range exposes `Segments()` (tuple of plain [begin, end) ranges) and
+ * `SegmentIterator<index>(local)`, so algorithms run a plain std algorithm on every segment
+ * instead of dispatching on the current segment for every element.
+ * Other ranges are processed by ordinary loops.
+ * ForEach needs nothing special: Concatenate::ForEach already runs the segments one after another.
+ */
+
+namespace NPrivate {
+
+    template <typename TContainer>
+    static constexpr bool IsSegmented(int32_t, decltype(std::remove_reference_t<TContainer>::Segmented)*) {
+        return std::remove_reference_t<TContainer>::Segmented;
+    }
+
+    template <typename TContainer>
+    static constexpr bool IsSegmented(char, std::nullptr_t*) {
+        return false;
+    }
+
+    template <std::size_t index = 0, typename TContainer, typename TSegments, typename TValue>
+    auto FindInSegments(const TContainer& container, const TSegments& segments, const TValue& value) {
+        const auto& segment = std::get<index>(segments);
+        auto local = std::find(segment.begin(), segment.end(), value);
+        if constexpr (index + 1 == std::tuple_size_v<TSegments>) {
+            if (local != segment.end()) {
+                return container.template SegmentIterator<index>(local);
+            }
+            return container.end();
+        } else {
+            if (local != segment.end()) {
+                return container.template SegmentIterator<index>(local);
+            }
+            return FindInSegments<index + 1>(container, segments, value);
+        }
+    }
+
+}
+
+//! Usage: auto sum = Accumulate(Concatenate(a, b), 0);
+template <typename TContainerOrRef, typename TValue, typename TBinaryOperation = std::plus<>>
+TValue Accumulate(TContainerOrRef&& container, TValue init, TBinaryOperation op = {}) {
+    if constexpr (NPrivate::IsSegmented<TContainerOrRef>((int32_t)0, nullptr)) {
+        std::apply([&init, &op](const auto&... segments) {
+            ((init = std::accumulate(segments.begin(), segments.end(), std::move(init), op)), ...);
+        }, container.Segments());
+    } else {
+        ::ForEach(container, [&init, &op](auto&& x) {
+            init = op(std::move(init), std::forward<decltype(x)>(x));
+        });
+    }
+    return init;
+}
+
+//! Usage: Copy(Concatenate(a, b), std::back_inserter(c));
+template <typename TContainerOrRef, typename TOutputIterator>
+TOutputIterator Copy(TContainerOrRef&& container, TOutputIterator out) {
+    if constexpr (NPrivate::IsSegmented<TContainerOrRef>((int32_t)0, nullptr)) {
+        std::apply([&out](const auto&... segments) {
+            ((out = std::copy(segments.begin(), segments.end(), out)), ...);
+        }, container.Segments());
+    } else {
+        ::ForEach(container, [&out](auto&& x) {
+            *out = std::forward<decltype(x)>(x);
+            ++out;
+        });
+    }
+    return out;
+}
+
+//! Usage: std::size_t zeros = Count(Concatenate(a, b), 0);
+template <typename TContainerOrRef, typename TValue>
+std::size_t Count(TContainerOrRef&& container, const TValue& value) {
+    std::size_t count = 0;
+    if constexpr (NPrivate::IsSegmented<TContainerOrRef>((int32_t)0, nullptr)) {
+        std::apply([&count, &value](const auto&... segments) {
+            ((count += std::count(segments.begin(), segments.end(), value)), ...);
+        }, container.Segments());
+    } else {
+        ::ForEach(container, [&count, &value](auto&& x) {
+            count += (x == value);
+        });
+    }
+    return count;
+}
+
+//! Returns iterator of the container pointing to the first element equal to value, or end-like iterator.
+//! The container must outlive the iterator, so pass an lvalue
+//! Usage: auto ab = Concatenate(a, b); auto it = Find(ab, 42);
+template <typename TContainerOrRef, typename TValue>
+auto Find(TContainerOrRef&& container, const TValue& value) {
+    if constexpr (NPrivate::IsSegmented<TContainerOrRef>((int32_t)0, nullptr)) {
+        return NPrivate::FindInSegments(container, container.Segments(), value);
+    } else {
+        auto it = std::begin(container);
+        for (auto last = std::end(container); it != last; ++it) {
+            if (*it == value) {
+                break;
+            }
+        }
+        return it;
+    }
+}
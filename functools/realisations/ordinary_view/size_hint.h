@@ -0,0 +1,97 @@
+#pragma once
+
+#include "traits.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+
+/** @file
+ * Size hints: number of elements of a range known without iteration.
+ * Adaptors implement member `TSizeHint SizeHint() const` combining hints of their inputs,
+ * containers with size (or random access iterators) give exact hints, other ranges give unknown ones.
+ */
+
+enum class ESizeHint {
+    Unknown,
+    //! Range has at most Size elements
+    UpperBound,
+    Exact,
+};
+
+struct TSizeHint {
+    ESizeHint Kind = ESizeHint::Unknown;
+    std::size_t Size = 0;
+
+    bool IsKnown() const {
+        return Kind != ESizeHint::Unknown;
+    }
+
+    bool IsExact() const {
+        return Kind == ESizeHint::Exact;
+    }
+
+    //! The same bound, but not exact (e.g. for Filter)
+    TSizeHint AsUpperBound() const {
+        return {IsKnown() ? ESizeHint::UpperBound : ESizeHint::Unknown, Size};
+    }
+
+    //! Size of sequential combination (Concatenate)
+    friend TSizeHint operator+(const TSizeHint& a, const TSizeHint& b) {
+        if (!a.IsKnown() || !b.IsKnown()) {
+            return {};
+        }
+        return {std::min(a.Kind, b.Kind), a.Size + b.Size};
+    }
+
+    //! Size of product (CartesianProduct), exact zero makes the whole product empty
+    friend TSizeHint operator*(const TSizeHint& a, const TSizeHint& b) {
+        if ((a.IsExact() && !a.Size) || (b.IsExact() && !b.Size)) {
+            return {ESizeHint::Exact, 0};
+        }
+        if (!a.IsKnown() || !b.IsKnown()) {
+            return {};
+        }
+        return {std::min(a.Kind, b.Kind), a.Size * b.Size};
+    }
+
+    //! Size of the shortest (Zip), any known size bounds the result
+    static TSizeHint Min(const TSizeHint& a, const TSizeHint& b) {
+        if (!a.IsKnown() || !b.IsKnown()) {
+            return a.IsKnown() ? a.AsUpperBound() : b.AsUpperBound();
+        }
+        if (a.IsExact() && b.IsExact()) {
+            return {ESizeHint::Exact, std::min(a.Size, b.Size)};
+        }
+        return {ESizeHint::UpperBound, std::min(a.Size, b.Size)};
+    }
+};
+
+namespace NPrivate {
+
+    template <typename TContainer>
+    static constexpr bool HasSizeHint(int32_t, decltype(std::declval<const TContainer&>().SizeHint())*) {
+        return true;
+    }
+
+    template <typename TContainer>
+    static constexpr bool HasSizeHint(char, std::nullptr_t*) {
+        return false;
+    }
+
+}
+
+//! Usage: if (auto hint = SizeHint(range); hint.IsKnown()) { result.reserve(hint.Size); }
+template <typename TContainer>
+TSizeHint SizeHint(const TContainer& container) {
+    if constexpr (NPrivate::HasSizeHint<TContainer>((int32_t)0, nullptr)) {
+        return container.SizeHint();
+    } else if constexpr (NPrivate::HasSize<const TContainer>(0)) {
+        return {ESizeHint::Exact, std::size_t(std::size(container))};
+    } else if constexpr (NPrivate::HasRandomAccessRange<const TContainer>()) {
+        return {ESizeHint::Exact, std::size_t(std::end(container) - std::begin(container))};
+    } else {
+        return {};
+    }
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "size_hint.h"
+#include "traits.h"
+
+#include <util/generic/store_policy.h>
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+
+
+namespace NPrivate {
+
+    struct TSliceBounds {
+        std::ptrdiff_t Start = 0;
+        std::ptrdiff_t Step = 1;
+        //! -1 means "until the end of the range"
+        std::ptrdiff_t Count = -1;
+    };
+
+    //! slice(start, stop, step).indices(size) of python
+    inline TSliceBounds ResolveSlice(std::optional<std::ptrdiff_t> start, std::optional<std::ptrdiff_t> stop,
+                                     std::ptrdiff_t step, std::ptrdiff_t size) {
+        if (step == 0) {
+            throw std::invalid_argument("Slice: step must not be zero");
+        }
+        const std::ptrdiff_t lower = step > 0 ? 0 : -1;
+        const std::ptrdiff_t upper = step > 0 ? size : size - 1;
+        auto resolve = [&](std::optional<std::ptrdiff_t> index, std::ptrdiff_t byDefault) {
+            if (!index) {
+                return byDefault;
+            }
+            std::ptrdiff_t result = *index < 0 ? *index + size : *index;
+            return std::clamp(result, lower, upper);
+        };
+        TSliceBounds bounds;
+        bounds.Start = resolve(start, step > 0 ? lower : upper);
+        bounds.Step = step;
+        const std::ptrdiff_t end = resolve(stop, step > 0 ? upper : lower);
+        if (step > 0) {
+            bounds.Count = end > bounds.Start ? (end - bounds.Start + step - 1) / step : 0;
+        } else {
+            bounds.Count = bounds.Start > end ? (bounds.Start - end - step - 1) / -step : 0;
+        }
+        return bounds;
+    }
+
+    //! Size is unknown, so only non-negative indexes and positive step are possible
+    inline TSliceBounds ResolveSlice(std::optional<std::ptrdiff_t> start, std::optional<std::ptrdiff_t> stop, std::ptrdiff_t step) {
+        if (step <= 0) {
+            throw std::invalid_argument("Slice: step must be positive for ranges of unknown size");
+        }
+        if (start.value_or(0) < 0 || stop.value_or(0) < 0) {
+            throw std::invalid_argument("Slice: negative indexes need a range of known size");
+        }
+        TSliceBounds bounds;
+        bounds.Start = start.value_or(0);
+        bounds.Step = step;
+        if (stop) {
+            bounds.Count = *stop > bounds.Start ? (*stop - bounds.Start + step - 1) / step : 0;
+        }
+        return bounds;
+    }
+
+    template <typename TContainer>
+    struct TSlicer {
+    private:
+        using TStorage = TAutoEmbedOrPtrPolicy<TContainer>;
+        using TIteratorState = decltype(std::begin(std::declval<TContainer&>()));
+        using TSentinelState = decltype(std::end(std::declval<TContainer&>()));
+        using TValue = decltype(*std::declval<TIteratorState&>());
+
+    public:
+        //! Iterator keeps begin of the container and the index in the slice
+        static constexpr bool RandomAccess = HasRandomAccessRange<TContainer>();
+
+    private:
+        struct TRandomAccessIterator {
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::decay_t<TValue>;
+            using pointer = std::remove_reference_t<TValue>*;
+            using reference = TValue;
+            using iterator_category = std::random_access_iterator_tag;
+
+            TValue operator*() const {
+                return *(Begin_ + (Start_ + Index_ * Step_));
+            }
+            TValue operator[](difference_type n) const {
+                return *(Begin_ + (Start_ + (Index_ + n) * Step_));
+            }
+            TRandomAccessIterator& operator++() {
+                ++Index_;
+                return *this;
+            }
+            TRandomAccessIterator operator++(int) {
+                TRandomAccessIterator result = *this;
+                ++Index_;
+                return result;
+            }
+            TRandomAccessIterator& operator--() {
+                --Index_;
+                return *this;
+            }
+            TRandomAccessIterator operator--(int) {
+                TRandomAccessIterator result = *this;
+                --Index_;
+                return result;
+            }
+            TRandomAccessIterator& operator+=(difference_type n) {
+                Index_ += n;
+                return *this;
+            }
+            TRandomAccessIterator& operator-=(difference_type n) {
+                Index_ -= n;
+                return *this;
+            }
+            TRandomAccessIterator operator+(difference_type n) const {
+                TRandomAccessIterator result = *this;
+                return result += n;
+            }
+            friend TRandomAccessIterator operator+(difference_type n, const TRandomAccessIterator& iterator) {
+                return iterator + n;
+            }
+            TRandomAccessIterator operator-(difference_type n) const {
+                TRandomAccessIterator result = *this;
+                return result -= n;
+            }
+            difference_type operator-(const TRandomAccessIterator& other) const {
+                return Index_ - other.Index_;
+            }
+            bool operator!=(const TRandomAccessIterator& other) const {
+                return Index_ != other.Index_;
+            }
+            bool operator==(const TRandomAccessIterator& other) const {
+                return Index_ == other.Index_;
+            }
+            bool operator<(const TRandomAccessIterator& other) const {
+                return Index_ < other.Index_;
+            }
+            bool operator>(const TRandomAccessIterator& other) const {
+                return Index_ > other.Index_;
+            }
+            bool operator<=(const TRandomAccessIterator& other) const {
+                return Index_ <= other.Index_;
+            }
+            bool operator>=(const TRandomAccessIterator& other) const {
+                return Index_ >= other.Index_;
+            }
+
+            TIteratorState Begin_;
+            difference_type Start_;
+            difference_type Step_;
+            difference_type Index_;
+        };
+
+        struct TInputSentinel {
+            TSentinelState Iterator_;
+        };
+
+        struct TInputIterator {
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::decay_t<TValue>;
+            using pointer = std::remove_reference_t<TValue>*;
+            using reference = TValue;
+            using iterator_category = std::input_iterator_tag;
+
+            TValue operator*() const {
+                return *Iterator_;
+            }
+            TInputIterator& operator++() {
+                // stop early: the rest of the container is never touched
+                if (--Remaining_) {
+                    Skip(Step_);
+                }
+                return *this;
+            }
+            bool operator!=(const TInputSentinel& other) const {
+                return Remaining_ != 0 && Iterator_ != other.Iterator_;
+            }
+            bool operator==(const TInputSentinel& other) const {
+                return !(*this != other);
+            }
+
+            void Skip(std::ptrdiff_t count) {
+                for (; count > 0 && Iterator_ != End_; --count) {
+                    ++Iterator_;
+                }
+            }
+
+            TIteratorState Iterator_;
+            TSentinelState End_;
+            std::ptrdiff_t Step_;
+            //! Number of elements left including the current one, negative when unknown
+            std::ptrdiff_t Remaining_;
+        };
+
+        using TIterator = std::conditional_t<RandomAccess, TRandomAccessIterator, TInputIterator>;
+        using TSentinel = std::conditional_t<RandomAccess, TRandomAccessIterator, TInputSentinel>;
+
+    public:
+        using iterator = TIterator;
+        using const_iterator = TIterator;
+        using size_type = std::size_t;
+
+        TIterator begin() const {
+            if constexpr (RandomAccess) {
+                return {std::begin(*Storage_.Ptr()), Bounds_.Start, Bounds_.Step, 0};
+            } else {
+                TIterator iterator{std::begin(*Storage_.Ptr()), std::end(*Storage_.Ptr()), Bounds_.Step, Bounds_.Count};
+                iterator.Skip(Bounds_.Start);
+                return iterator;
+            }
+        }
+
+        TSentinel end() const {
+            if constexpr (RandomAccess) {
+                return {std::begin(*Storage_.Ptr()), Bounds_.Start, Bounds_.Step, Bounds_.Count};
+            } else {
+                return {std::end(*Storage_.Ptr())};
+            }
+        }
+
+        size_type size() const {
+            static_assert(RandomAccess, "Use SizeHint for slices of not random access ranges");
+            return Bounds_.Count;
+        }
+
+        bool empty() const {
+            return !(begin() != end());
+        }
+
+        TValue operator[](size_type at) const {
+            static_assert(RandomAccess);
+            return begin()[at];
+        }
+
+        TSizeHint SizeHint() const {
+            const TSizeHint hint = ::SizeHint(*Storage_.Ptr());
+            if (hint.IsExact()) {
+                // bounds were resolved with this size
+                return {ESizeHint::Exact, std::size_t(Bounds_.Count)};
+            }
+            if (Bounds_.Count < 0) {
+                return hint.IsKnown() ? TSizeHint{ESizeHint::UpperBound, hint.Size} : TSizeHint{};
+            }
+            return TSizeHint::Min({ESizeHint::UpperBound, std::size_t(Bounds_.Count)}, hint);
+        }
+
+        mutable TStorage Storage_;
+        TSliceBounds Bounds_;
+    };
+
+}
+
+//! Acts as python slice: range[start:stop:step], negative indexes count from the end
+//! Random access ranges are sliced in O(1) and the slice is random access.
+//! Other ranges are skipped element by element and iteration stops right after the last element of the slice;
+//! negative indexes are possible for them only when their size is known (see SizeHint), negative steps are not possible.
+//! Throws std::invalid_argument for zero step and for bounds that the range does not support
+//! Usage: for (auto x : Slice(a, 1, -1)) {...}
+//!        for (auto x : Slice(a, {}, {}, -2)) {...}  // a[::-2]
+template <typename TContainerOrRef>
+auto Slice(TContainerOrRef&& container, std::optional<std::ptrdiff_t> start,
+           std::optional<std::ptrdiff_t> stop = std::nullopt, std::ptrdiff_t step = 1) {
+    using TSlicer = NPrivate::TSlicer<TContainerOrRef>;
+    NPrivate::TSliceBounds bounds;
+    if (const TSizeHint hint = SizeHint(container); hint.IsExact()) {
+        bounds = NPrivate::ResolveSlice(start, stop, step, hint.Size);
+    } else {
+        bounds = NPrivate::ResolveSlice(start, stop, step);
+    }
+    if constexpr (!TSlicer::RandomAccess) {
+        if (bounds.Step < 0) {
+            throw std::invalid_argument("Slice: only random access ranges can be sliced with negative step");
+        }
+    }
+    return TSlicer{std::forward<TContainerOrRef>(container), bounds};
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <util/generic/adaptor.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+
+/** @file
+ * Static extent: number of elements known at compile time.
+ * std::array and C arrays have it, adaptors combine extents of their inputs in member `static constexpr std::size_t Extent`:
+ * Map, Enumerate and Reversed keep the extent of the input, Zip takes the shortest one,
+ * Concatenate the sum and CartesianProduct the product. Other ranges (e.g. std::vector, Filter) have DynamicExtent.
+ */
+
+namespace NPrivate {
+
+    static constexpr std::size_t DynamicExtent = std::numeric_limits<std::size_t>::max();
+
+    //! Small static extents: loops over them are unrolled
+    static constexpr std::size_t UnrollExtent = 16;
+
+    template <typename TContainer>
+    struct TStaticExtent {
+        static constexpr std::size_t Value = DynamicExtent;
+    };
+
+    template <typename T, std::size_t N>
+    struct TStaticExtent<T[N]> {
+        static constexpr std::size_t Value = N;
+    };
+
+    template <typename T, std::size_t N>
+    struct TStaticExtent<std::array<T, N>> {
+        static constexpr std::size_t Value = N;
+    };
+
+    template <typename TRange>
+    struct TStaticExtent<TReverseRange<TRange>>;
+
+    template <typename TContainer>
+    static constexpr std::size_t ExtentOf(int32_t, decltype(TContainer::Extent)*) {
+        return TContainer::Extent;
+    }
+
+    template <typename TContainer>
+    static constexpr std::size_t ExtentOf(char, std::nullptr_t*) {
+        return TStaticExtent<TContainer>::Value;
+    }
+
+    //! Usage: if constexpr (StaticExtent<TContainer>() != DynamicExtent) {...}
+    template <typename TContainer>
+    constexpr std::size_t StaticExtent() {
+        using TDecayed = std::remove_cv_t<std::remove_reference_t<TContainer>>;
+        return ExtentOf<TDecayed>((int32_t)0, nullptr);
+    }
+
+    template <typename TRange>
+    struct TStaticExtent<TReverseRange<TRange>> {
+        static constexpr std::size_t Value = StaticExtent<TRange>();
+    };
+
+    //! Extent of Zip: the shortest of the inputs, an empty input makes it empty
+    template <typename... TContainers>
+    constexpr std::size_t MinExtent() {
+        constexpr std::size_t extents[] = {StaticExtent<TContainers>()...};
+        std::size_t result = DynamicExtent;
+        bool dynamic = false;
+        for (std::size_t extent : extents) {
+            if (extent == DynamicExtent) {
+                dynamic = true;
+            } else if (extent < result) {
+                result = extent;
+            }
+        }
+        return dynamic && result ? DynamicExtent : result;
+    }
+
+    //! Extent of Concatenate
+    template <typename... TContainers>
+    constexpr std::size_t SumExtent() {
+        if constexpr (((StaticExtent<TContainers>() != DynamicExtent) && ...)) {
+            return (StaticExtent<TContainers>() + ...);
+        } else {
+            return DynamicExtent;
+        }
+    }
+
+    //! Extent of CartesianProduct, an empty input makes it empty
+    template <typename... TContainers>
+    constexpr std::size_t ProductExtent() {
+        if constexpr (((StaticExtent<TContainers>() == 0) || ...)) {
+            return 0;
+        } else if constexpr (((StaticExtent<TContainers>() != DynamicExtent) && ...)) {
+            return (StaticExtent<TContainers>() * ...);
+        } else {
+            return DynamicExtent;
+        }
+    }
+
+    //! Inputs with static extents have the same one
+    template <typename... TContainers>
+    constexpr bool SameStaticExtents() {
+        constexpr std::size_t extents[] = {StaticExtent<TContainers>()...};
+        std::size_t first = DynamicExtent;
+        for (std::size_t extent : extents) {
+            if (first == DynamicExtent) {
+                first = extent;
+            } else if (extent != DynamicExtent && extent != first) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
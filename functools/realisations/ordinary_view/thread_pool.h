@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+/** @file
+ * Thread pool for parallel loops.
+ * A loop over [0, size) is cut into grains (index ranges of at most `grain` elements),
+ * every participant gets a contiguous share of grains into its own deque.
+ * The owner takes grains from the front of its deque (so it walks its share forward),
+ * participants without work steal from the back of the others' deques.
+ * The calling thread participates too, so nested loops and loops started from workers never deadlock.
+ */
+
+namespace NPrivate {
+
+    class TThreadPool {
+    public:
+        TThreadPool() = default;
+
+        ~TThreadPool() {
+            {
+                std::lock_guard<std::mutex> guard(Mutex_);
+                Stopped_ = true;
+            }
+            HasTasks_.notify_all();
+            for (auto& worker : Workers_) {
+                worker.join();
+            }
+        }
+
+        //! Pool of the process, it has no threads until the first parallel loop
+        static TThreadPool& Instance() {
+            static TThreadPool pool;
+            return pool;
+        }
+
+        //! Makes the pool able to run `concurrency` participants of a loop at once (workers and the caller),
+        //! zero means one per core. Returns the number of participants the loop may use
+        std::size_t Reserve(std::size_t concurrency) {
+            if (!concurrency) {
+                concurrency = std::max(1u, std::thread::hardware_concurrency());
+            }
+            std::lock_guard<std::mutex> guard(Mutex_);
+            while (Workers_.size() + 1 < concurrency) {
+                Workers_.emplace_back([this] {
+                    Work();
+                });
+            }
+            return concurrency;
+        }
+
+        void Submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> guard(Mutex_);
+                Tasks_.push_back(std::move(task));
+            }
+            HasTasks_.notify_one();
+        }
+
+    private:
+        void Work() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(Mutex_);
+                    HasTasks_.wait(lock, [this] { return Stopped_ || !Tasks_.empty(); });
+                    if (Tasks_.empty()) {
+                        return;
+                    }
+                    task = std::move(Tasks_.front());
+                    Tasks_.pop_front();
+                }
+                task();
+            }
+        }
+
+        std::vector<std::thread> Workers_;
+        std::mutex Mutex_;
+        std::condition_variable HasTasks_;
+        std::deque<std::function<void()>> Tasks_;
+        bool Stopped_ = false;
+    };
+
+    //! State of one parallel loop, shared with the helper tasks (they may start after the loop is finished)
+    class TParallelLoop {
+    public:
+        using TGrain = std::pair<std::ptrdiff_t, std::ptrdiff_t>;
+        using TBody = std::function<void(std::ptrdiff_t, std::ptrdiff_t)>;
+
+        TParallelLoop(std::ptrdiff_t size, std::ptrdiff_t grain, std::size_t participants, TBody body)
+            : Queues_(participants)
+            , Body_(std::move(body))
+            , Remaining_((size + grain - 1) / grain)
+        {
+            const std::ptrdiff_t grainCount = Remaining_;
+            for (std::ptrdiff_t j = 0; j < grainCount; ++j) {
+                auto& queue = Queues_[j * std::ptrdiff_t(participants) / grainCount];
+                queue.Grains_.emplace_back(j * grain, std::min(size, (j + 1) * grain));
+            }
+        }
+
+        void Participate(std::size_t self) {
+            TGrain grain;
+            while (Pop(self, grain) || Steal(self, grain)) {
+                if (!Failed_.load(std::memory_order_relaxed)) {
+                    try {
+                        Body_(grain.first, grain.second);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> guard(ErrorMutex_);
+                        if (!Error_) {
+                            Error_ = std::current_exception();
+                        }
+                        Failed_ = true;
+                    }
+                }
+                if (Remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> guard(DoneMutex_);
+                    Done_.notify_all();
+                }
+            }
+        }
+
+        //! Waits for all the grains and rethrows the first exception of the body
+        void Wait() {
+            std::unique_lock<std::mutex> lock(DoneMutex_);
+            Done_.wait(lock, [this] { return Remaining_.load(std::memory_order_acquire) == 0; });
+            if (Error_) {
+                std::rethrow_exception(Error_);
+            }
+        }
+
+    private:
+        struct TQueue {
+            std::mutex Mutex_;
+            std::deque<TGrain> Grains_;
+        };
+
+        bool Pop(std::size_t self, TGrain& grain) {
+            auto& queue = Queues_[self];
+            std::lock_guard<std::mutex> guard(queue.Mutex_);
+            if (queue.Grains_.empty()) {
+                return false;
+            }
+            grain = queue.Grains_.front();
+            queue.Grains_.pop_front();
+            return true;
+        }
+
+        bool Steal(std::size_t self, TGrain& grain) {
+            for (std::size_t shift = 1; shift < Queues_.size(); ++shift) {
+                auto& queue = Queues_[(self + shift) % Queues_.size()];
+                std::lock_guard<std::mutex> guard(queue.Mutex_);
+                if (!queue.Grains_.empty()) {
+                    grain = queue.Grains_.back();
+                    queue.Grains_.pop_back();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::vector<TQueue> Queues_;
+        TBody Body_;
+        std::atomic<std::ptrdiff_t> Remaining_;
+        std::atomic<bool> Failed_ = false;
+        std::mutex ErrorMutex_;
+        std::exception_ptr Error_;
+        std::mutex DoneMutex_;
+        std::condition_variable Done_;
+    };
+
+    //! Calls body(begin, end) for subranges covering [0, size), up to `threads` of them concurrently
+    //! Zero threads means one thread per core, zero grain means about 8 grains per thread
+    template <typename TBody>
+    void ParallelFor(std::ptrdiff_t size, std::size_t threads, std::size_t grain, TBody&& body) {
+        if (size <= 0) {
+            return;
+        }
+        auto& pool = TThreadPool::Instance();
+        std::size_t participants = pool.Reserve(threads);
+        if (!grain) {
+            grain = std::max<std::ptrdiff_t>(1, size / std::ptrdiff_t(participants * 8));
+        }
+        participants = std::min<std::size_t>(participants, (size + grain - 1) / grain);
+        if (participants == 1) {
+            body(std::ptrdiff_t(0), size);
+            return;
+        }
+        auto loop = std::make_shared<TParallelLoop>(size, std::ptrdiff_t(grain), participants, std::ref(body));
+        for (std::size_t i = 1; i < participants; ++i) {
+            pool.Submit([loop, i] {
+                loop->Participate(i);
+            });
+        }
+        loop->Participate(0);
+        loop->Wait();
+    }
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "static_extent.h"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+
+/** @file
+ * Materialization into std::array of a size known at compile time.
+ * Map, Filter, Enumerate, Zip, Concatenate, CartesianProduct, Reversed, Range and the pipe stages are constexpr,
+ * so a lookup table can be built by a chain of them at compile time:
+ * constexpr auto squares = ToArray<256>(Map([](int x) { return x * x; }, Range(256)));
+ * This holds while the functors and the containers that they hold by value are const safe (see TViewEmbedPolicy):
+ * stateful functors (mutable lambdas) and containers moved into a chain make it runtime only.
+ * Slice, Chunks and CartesianProductTiled keep mutable state and are runtime only.
+ * Size of a chain over std::array and C arrays is known from its static extent, so it may be omitted.
+ */
+
+//! Range must have exactly N elements, otherwise std::invalid_argument is thrown (compile error in constant evaluation)
+//! Usage: constexpr auto table = ToArray<256>(Map(f, Range(256)));
+template <std::size_t N, typename TContainer>
+constexpr auto ToArray(TContainer&& container) {
+    using TValue = std::decay_t<decltype(*std::begin(container))>;
+    static_assert(std::is_default_constructible_v<TValue>, "elements of std::array are default constructed first");
+    std::array<TValue, N> result{};
+    std::size_t count = 0;
+    auto it = std::begin(container);
+    const auto end = std::end(container);
+    for (; count < N && it != end; ++it, ++count) {
+        result[count] = *it;
+    }
+    if (count != N || it != end) {
+        throw std::invalid_argument("ToArray: length of the range differs from the size of the array");
+    }
+    return result;
+}
+
+//! Materialization without heap of a range with a static extent
+//! Usage: std::array<float, 3> sum = ToArray(Map([](auto p) { auto [x, y] = p; return x + y; }, Zip(a, b)));
+template <typename TContainer>
+constexpr auto ToArray(TContainer&& container) {
+    constexpr std::size_t extent = NPrivate::StaticExtent<TContainer>();
+    static_assert(extent != NPrivate::DynamicExtent, "size of the range is not known at compile time, use ToArray<N>");
+    return ToArray<extent>(std::forward<TContainer>(container));
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+
+namespace NPrivate {
+
+    template <typename TContainer, typename TIteratorCategory = typename std::iterator_traits<decltype(std::begin(std::declval<TContainer>()))>::iterator_category>
+    static constexpr bool HasRandomAccessIterator(int32_t) {
+        return std::is_same_v<TIteratorCategory, std::random_access_iterator_tag>;
+    }
+
+    template <typename TContainer>
+    static constexpr bool HasRandomAccessIterator(uint32_t) {
+        return false;
+    }
+
+    //! std::size is applicable and begin() has the same type as end()
+    template <typename TContainer, typename TSize = decltype(std::size(std::declval<TContainer&>()))>
+    static constexpr bool HasSize(int32_t) {
+        return std::is_same_v<decltype(std::begin(std::declval<TContainer&>())), decltype(std::end(std::declval<TContainer&>()))>;
+    }
+
+    template <typename TContainer>
+    static constexpr bool HasSize(uint32_t) {
+        return false;
+    }
+
+    template <typename TContainer, typename TIteratorCategory = typename std::iterator_traits<decltype(std::begin(std::declval<TContainer&>()))>::iterator_category>
+    static constexpr bool HasBidirectionalIterator(int32_t) {
+        return std::is_base_of_v<std::bidirectional_iterator_tag, TIteratorCategory>;
+    }
+
+    template <typename TContainer>
+    static constexpr bool HasBidirectionalIterator(uint32_t) {
+        return false;
+    }
+
+    //! Random access iterator and begin() has the same type as end(), so the range can be split by indexes
+    template <typename TContainer>
+    static constexpr bool HasRandomAccessRange() {
+        return HasRandomAccessIterator<TContainer>(0) &&
+            std::is_same_v<decltype(std::begin(std::declval<TContainer&>())), decltype(std::end(std::declval<TContainer&>()))>;
+    }
+
+}
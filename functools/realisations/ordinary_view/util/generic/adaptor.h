@@ -11,13 +11,14 @@ namespace NPrivate {
     template<class Range>
     class TReverseRangeStorage {
     public:
-        TReverseRangeStorage(Range&& range) : Base_(std::forward<Range>(range)) {}
+        constexpr TReverseRangeStorage(Range&& range) : Base_(std::forward<Range>(range)) {}
 
-        decltype(auto) Base() const {
-            return *Base_.Ptr();
+        constexpr decltype(auto) Base() const {
+            const auto& base = *Base_.Ptr();
+            return base;
         }
 
-        decltype(auto) Base() {
+        constexpr decltype(auto) Base() {
             return *Base_.Ptr();
         }
 
@@ -42,19 +43,19 @@ namespace NPrivate {
         using TBase::TBase;
         using TBase::Base;
 
-        auto begin() const {
+        constexpr auto begin() const {
             return Base().rbegin();
         }
 
-        auto end() const {
+        constexpr auto end() const {
             return Base().rend();
         }
 
-        auto begin() {
+        constexpr auto begin() {
             return Base().rbegin();
         }
 
-        auto end() {
+        constexpr auto end() {
             return Base().rend();
         }
     };
@@ -66,22 +67,22 @@ namespace NPrivate {
         using TBase::TBase;
         using TBase::Base;
 
-        auto begin() const {
+        constexpr auto begin() const {
             using std::end;
             return std::make_reverse_iterator(end(Base()));
         }
 
-        auto end() const {
+        constexpr auto end() const {
             using std::begin;
             return std::make_reverse_iterator(begin(Base()));
         }
 
-        auto begin() {
+        constexpr auto begin() {
             using std::end;
             return std::make_reverse_iterator(end(Base()));
         }
 
-        auto end() {
+        constexpr auto end() {
             using std::begin;
             return std::make_reverse_iterator(begin(Base()));
         }
@@ -97,22 +98,22 @@ namespace NPrivate {
         TReverseRange(TReverseRange&&) = default;
         TReverseRange(const TReverseRange&) = default;
 
-        auto rbegin() const {
+        constexpr auto rbegin() const {
             using std::begin;
             return begin(Base());
         }
 
-        auto rend() const {
+        constexpr auto rend() const {
             using std::end;
             return end(Base());
         }
 
-        auto rbegin() {
+        constexpr auto rbegin() {
             using std::begin;
             return begin(Base());
         }
 
-        auto rend() {
+        constexpr auto rend() {
             using std::end;
             return end(Base());
         }
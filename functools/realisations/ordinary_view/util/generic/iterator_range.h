@@ -7,26 +7,26 @@ template <typename TBegin, typename TEnd = TBegin>
 struct TIteratorRange {
     using TElement = std::remove_reference_t<decltype(*std::declval<TBegin>())>;
 
-    TIteratorRange(TBegin begin, TEnd end)
+    constexpr TIteratorRange(TBegin begin, TEnd end)
         : Begin_(begin)
         , End_(end)
     {
     }
 
-    TIteratorRange()
+    constexpr TIteratorRange()
         : TIteratorRange(TBegin{}, TEnd{})
     {
     }
 
-    TBegin begin() const {
+    constexpr TBegin begin() const {
         return Begin_;
     }
 
-    TEnd end() const {
+    constexpr TEnd end() const {
         return End_;
     }
 
-    bool empty() const {
+    constexpr bool empty() const {
         // because range based for requires exactly '!='
         return !(Begin_ != End_);
     }
@@ -47,35 +47,35 @@ public:
     using difference_type = typename std::iterator_traits<iterator>::difference_type;
     using size_type = std::size_t;
 
-    TIteratorRange()
+    constexpr TIteratorRange()
         : Begin_()
         , End_()
     {
     }
 
-    TIteratorRange(TIterator begin, TIterator end)
+    constexpr TIteratorRange(TIterator begin, TIterator end)
         : Begin_(begin)
         , End_(end)
     {
     }
 
-    TIterator begin() const {
+    constexpr TIterator begin() const {
         return Begin_;
     }
 
-    TIterator end() const {
+    constexpr TIterator end() const {
         return End_;
     }
 
-    bool empty() const {
+    constexpr bool empty() const {
         return Begin_ == End_;
     }
 
-    size_type size() const {
+    constexpr size_type size() const {
         return End_ - Begin_;
     }
 
-    reference operator[](size_t at) const {
+    constexpr reference operator[](size_t at) const {
         Y_ASSERT(at < size());
 
         return *(Begin_ + at);
@@ -87,16 +87,16 @@ private:
 };
 
 template <class TIterator>
-TIteratorRange<TIterator> MakeIteratorRange(TIterator begin, TIterator end) {
+constexpr TIteratorRange<TIterator> MakeIteratorRange(TIterator begin, TIterator end) {
     return TIteratorRange<TIterator>(begin, end);
 }
 
 template <class TIterator>
-TIteratorRange<TIterator> MakeIteratorRange(const std::pair<TIterator, TIterator>& range) {
+constexpr TIteratorRange<TIterator> MakeIteratorRange(const std::pair<TIterator, TIterator>& range) {
     return TIteratorRange<TIterator>(range.first, range.second);
 }
 
 template <class TBegin, class TEnd>
-TIteratorRange<TBegin, TEnd> MakeIteratorRange(TBegin begin, TEnd end) {
+constexpr TIteratorRange<TBegin, TEnd> MakeIteratorRange(TBegin begin, TEnd end) {
     return {begin, end};
 }
@@ -1,22 +1,20 @@
 #pragma once
 
-#include <utility>
 #include <cassert>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 #define Y_VERIFY assert
 
 template <class T>
 struct TPtrPolicy {
-    inline TPtrPolicy(T* t)
+    inline constexpr TPtrPolicy(T* t)
         : T_(t)
     {
     }
 
-    inline T* Ptr() noexcept {
-        return T_;
-    }
-
-    inline const T* Ptr() const noexcept {
+    inline constexpr T* Ptr() const noexcept {
         return T_;
     }
 
@@ -26,49 +24,134 @@ struct TPtrPolicy {
 template <class T>
 struct TEmbedPolicy {
     template <typename... Args>
-    inline TEmbedPolicy(Args&&... args)
+    inline constexpr TEmbedPolicy(Args&&... args)
         : T_(std::forward<Args>(args)...)
     {
     }
 
-    inline T* Ptr() noexcept {
+    inline constexpr T* Ptr() noexcept {
         return &T_;
     }
 
-    inline const T* Ptr() const noexcept {
+    inline constexpr const T* Ptr() const noexcept {
         return &T_;
     }
 
     T T_;
 };
 
+namespace NPrivate {
+    template <class TMember>
+    struct TIsConstMemberFunction : std::false_type {
+    };
+
+    template <class TResult, class TClass, class... TArgs>
+    struct TIsConstMemberFunction<TResult (TClass::*)(TArgs...) const> : std::true_type {
+    };
+
+    template <class TResult, class TClass, class... TArgs>
+    struct TIsConstMemberFunction<TResult (TClass::*)(TArgs...) const noexcept> : std::true_type {
+    };
+
+    //! Functor with the only operator() that is const (not generic lambdas: their operator() is a template)
+    template <class T, class = void>
+    struct TIsConstCallable : std::false_type {
+    };
+
+    template <class T>
+    struct TIsConstCallable<T, std::void_t<decltype(&T::operator())>> : TIsConstMemberFunction<decltype(&T::operator())> {
+    };
+
+    //! Range that gives the same iterators when it is const, e.g. views and xrange, but not containers
+    template <class T, class = void>
+    struct TIsConstTransparentRange : std::false_type {
+    };
+
+    template <class T>
+    struct TIsConstTransparentRange<T, std::void_t<
+        decltype(std::begin(std::declval<T&>())), decltype(std::begin(std::declval<const T&>())),
+        decltype(std::end(std::declval<T&>())), decltype(std::end(std::declval<const T&>()))>>
+        : std::bool_constant<
+            std::is_same_v<decltype(std::begin(std::declval<T&>())), decltype(std::begin(std::declval<const T&>()))> &&
+            std::is_same_v<decltype(std::end(std::declval<T&>())), decltype(std::end(std::declval<const T&>()))>>
+    {
+    };
+
+    //! Object that views can use as const: scalars (function pointers), functors with const operator()
+    //! and ranges that do not differ when const. Map and Filter check their functors by the arguments instead
+    template <class T>
+    struct TIsConstSafe : std::bool_constant<
+        std::is_scalar_v<T> || TIsConstCallable<T>::value || TIsConstTransparentRange<T>::value>
+    {
+    };
+}
+
+//! Object embedded into a view. Views are used as const, but give non-const access to the objects they hold,
+//! so the object is mutable: stateful functors and containers held by value are used at runtime only,
+//! since GCC does not read mutable members in constant expressions
+template <class T, bool ConstSafe = NPrivate::TIsConstSafe<T>::value>
+struct TViewEmbedPolicy {
+    template <typename... Args>
+    inline constexpr TViewEmbedPolicy(Args&&... args)
+        : T_(std::forward<Args>(args)...)
+    {
+    }
+
+    inline T* Ptr() const noexcept {
+        return &T_;
+    }
+
+    mutable T T_;
+};
+
+//! Object that views use as const, so it needs not be mutable and views holding it are constexpr
+template <class T>
+struct TViewEmbedPolicy<T, true> {
+    template <typename... Args>
+    inline constexpr TViewEmbedPolicy(Args&&... args)
+        : T_(std::forward<Args>(args)...)
+    {
+    }
+
+    inline constexpr T* Ptr() noexcept {
+        return &T_;
+    }
+
+    inline constexpr const T* Ptr() const noexcept {
+        return &T_;
+    }
+
+    T T_;
+};
 
-template <class TRefOrObject, bool IsReference = std::is_reference<TRefOrObject>::value>
+//! ConstSafe chooses the policy of objects held by value (see TViewEmbedPolicy)
+template <class TRefOrObject, bool IsReference = std::is_reference<TRefOrObject>::value,
+          bool ConstSafe = NPrivate::TIsConstSafe<std::remove_reference_t<TRefOrObject>>::value>
 struct TAutoEmbedOrPtrPolicy;
 
-template <class TReference>
-struct TAutoEmbedOrPtrPolicy<TReference, true> : TPtrPolicy<typename std::remove_reference<TReference>::type> {
+template <class TReference, bool ConstSafe>
+struct TAutoEmbedOrPtrPolicy<TReference, true, ConstSafe> : TPtrPolicy<typename std::remove_reference<TReference>::type> {
     using TObject = typename std::remove_reference<TReference>::type;
     using TObjectStorage = TObject*;
 
-    TAutoEmbedOrPtrPolicy(TReference& reference)
+    constexpr TAutoEmbedOrPtrPolicy(TReference& reference)
         : TPtrPolicy<TObject>(&reference)
     {
     }
 };
 
-template <class TObject_>
-struct TAutoEmbedOrPtrPolicy<TObject_, false> : TEmbedPolicy<TObject_> {
+template <class TObject_, bool ConstSafe>
+struct TAutoEmbedOrPtrPolicy<TObject_, false, ConstSafe> : TViewEmbedPolicy<TObject_, ConstSafe> {
     using TObject = TObject_;
     using TObjectStorage = TObject;
 
-    TAutoEmbedOrPtrPolicy(TObject& object)
-        : TEmbedPolicy<TObject>(std::move(object))
+    constexpr TAutoEmbedOrPtrPolicy(TObject& object)
+        : TViewEmbedPolicy<TObject, ConstSafe>(std::move(object))
     {
     }
 
-    TAutoEmbedOrPtrPolicy(TObject&& object)
-        : TEmbedPolicy<TObject>(std::move(object))
+    constexpr TAutoEmbedOrPtrPolicy(TObject&& object)
+        : TViewEmbedPolicy<TObject, ConstSafe>(std::move(object))
     {
     }
 };
@@ -5,6 +5,7 @@
 //#include <util/system/yassert.h>
 #include <iterator>
 #include <algorithm>
+#include <stdexcept>
 
 /** @file
  * Some similar for python xrange(): https://docs.python.org/2/library/functions.html#xrange
@@ -56,7 +57,7 @@ namespace NPrivate {
                 return Value == other.Value;
             }
 
-            TIterator& operator++() noexcept {
+            constexpr TIterator& operator++() noexcept {
                 ++Value;
                 return *this;
             }
@@ -71,7 +72,7 @@ namespace NPrivate {
             }
 
             template <typename IntType>
-            TIterator& operator+=(const IntType& b) noexcept {
+            constexpr TIterator& operator+=(const IntType& b) noexcept {
                 Value += b;
                 return *this;
             }
@@ -115,20 +116,56 @@ namespace NPrivate {
         T Finish;
     };
 
-    template <typename T>
-    class TSteppedXRange {
+    //! Step of TSteppedXRange: compile time constant, or runtime value when StaticStep is 0
+    template <typename TDiff, TDiff StaticStep, bool IsStatic = StaticStep != 0>
+    class TXRangeStep {
+    public:
+        //! Iterators and size() use StaticStep, so a different runtime step is rejected
+        constexpr TXRangeStep(TDiff step) {
+            if (step != StaticStep) {
+                throw std::invalid_argument("xrange: step differs from the compile time step");
+            }
+        }
+
+        static constexpr TDiff Step() noexcept {
+            return StaticStep;
+        }
+    };
+
+    template <typename TDiff, TDiff StaticStep>
+    class TXRangeStep<TDiff, StaticStep, false> {
+    public:
+        constexpr TXRangeStep(TDiff step) noexcept
+            : Step_(step)
+        {
+        }
+
+        constexpr TDiff Step() const noexcept {
+            return Step_;
+        }
+
+    private:
+        TDiff Step_;
+    };
+
+    template <typename T, decltype(T() - T()) StaticStep = 0>
+    class TSteppedXRange: private TXRangeStep<decltype(T() - T()), StaticStep> {
         using TDiff = decltype(T() - T());
+        using TStep = TXRangeStep<TDiff, StaticStep>;
 
     public:
-        constexpr TSteppedXRange(T start, T finish, TDiff step) noexcept
-            : Start_(start)
-            , Step_(step)
-            , Finish_(CalcRealFinish(Start_, finish, Step_))
+        //! Throws std::invalid_argument for zero step and for step that differs from nonzero StaticStep
+        constexpr TSteppedXRange(T start, T finish, TDiff step = StaticStep)
+            : TStep(step)
+            , Start_(start)
+            , Finish_(CalcRealFinish(Start_, finish, step))
         {
             static_assert(std::is_integral<T>::value || std::is_pointer<T>::value, "T should be integral type or pointer");
         }
 
-        class TIterator {
+        // iterator keeps the step by value (no load through the range on every increment),
+        // with compile time step it is as small as T
+        class TIterator: private TStep {
         public:
             using value_type = T;
             using difference_type = TDiff;
@@ -136,9 +173,9 @@ namespace NPrivate {
             using reference = const T&;
             using iterator_category = std::random_access_iterator_tag;
 
-            constexpr TIterator(T value, const TSteppedXRange& parent) noexcept
-                : Value_(value)
-                , Parent_(&parent)
+            constexpr TIterator(T value, TStep step) noexcept
+                : TStep(step)
+                , Value_(value)
             {
             }
 
@@ -146,6 +183,10 @@ namespace NPrivate {
                 return Value_;
             }
 
+            constexpr T operator[](TDiff n) const noexcept {
+                return Value_ + n * this->Step();
+            }
+
             constexpr bool operator!=(const TIterator& other) const noexcept {
                 return Value_ != other.Value_;
             }
@@ -154,34 +195,72 @@ namespace NPrivate {
                 return Value_ == other.Value_;
             }
 
-            TIterator& operator++() noexcept {
-                Value_ += Parent_->Step_;
+            constexpr TIterator& operator++() noexcept {
+                Value_ += this->Step();
                 return *this;
             }
 
+            constexpr TIterator operator++(int) noexcept {
+                TIterator result = *this;
+                ++*this;
+                return result;
+            }
+
+            constexpr TIterator& operator--() noexcept {
+                Value_ -= this->Step();
+                return *this;
+            }
+
+            constexpr TIterator operator--(int) noexcept {
+                TIterator result = *this;
+                --*this;
+                return result;
+            }
+
             constexpr TDiff operator-(const TIterator& b) const noexcept {
-                return Value_ - b.Value_;
+                return (Value_ - b.Value_) / this->Step();
             }
 
             template <typename IntType>
             constexpr TIterator operator+(const IntType& b) const noexcept {
-                return TIterator(Value_ + b * Parent_->Step_, *Parent_);
+                return TIterator(Value_ + b * this->Step(), *this);
             }
 
             template <typename IntType>
-            TIterator& operator+=(const IntType& b) noexcept {
-                Value_ += b;
+            constexpr TIterator& operator+=(const IntType& b) noexcept {
+                Value_ += b * this->Step();
                 return *this;
             }
 
             template <typename IntType>
             constexpr TIterator operator-(const IntType& b) const noexcept {
-                return TIterator(Value_ - b * Parent_->Step_, Parent_);
+                return TIterator(Value_ - b * this->Step(), *this);
+            }
+
+            template <typename IntType>
+            constexpr TIterator& operator-=(const IntType& b) noexcept {
+                Value_ -= b * this->Step();
+                return *this;
+            }
+
+            constexpr bool operator<(const TIterator& b) const noexcept {
+                return *this - b < 0;
+            }
+
+            constexpr bool operator>(const TIterator& b) const noexcept {
+                return b < *this;
+            }
+
+            constexpr bool operator<=(const TIterator& b) const noexcept {
+                return !(b < *this);
+            }
+
+            constexpr bool operator>=(const TIterator& b) const noexcept {
+                return !(*this < b);
             }
 
         private:
             T Value_;
-            const TSteppedXRange* Parent_;
         };
 
         using value_type = T;
@@ -196,8 +275,10 @@ namespace NPrivate {
             return TIterator(Finish_, *this);
         }
 
-        static T CalcRealFinish(T start, T expFinish, TDiff step) {
-            //Y_ASSERT(step != 0);
+        static constexpr T CalcRealFinish(T start, T expFinish, TDiff step) {
+            if (step == 0) {
+                throw std::invalid_argument("xrange: step should not be zero");
+            }
             if (step > 0) {
                 if (expFinish > start) {
                     return start + step * ((expFinish - 1 - start) / step + 1);
@@ -207,8 +288,8 @@ namespace NPrivate {
             return start - TSteppedXRange<TDiff>::CalcRealFinish(0, start - expFinish, -step);
         }
 
-        constexpr T size() const noexcept {
-            return (Finish_ - Start_) / Step_;
+        constexpr TDiff size() const noexcept {
+            return (Finish_ - Start_) / this->Step();
         }
 
         template <class Container>
@@ -218,18 +299,25 @@ namespace NPrivate {
 
     private:
         const T Start_;
-        const TDiff Step_;
         const T Finish_;
     };
 
 }
 
-/// generate arithmetic progression that starts at start with certain step and stop at finish (not including)
+/// generate arithmetic progression that starts at start with certain step and stop at finish (not including),
+/// zero step throws std::invalid_argument
 template <typename T>
-constexpr ::NPrivate::TSteppedXRange<T> xrange(T start, T finish, decltype(T() - T()) step) noexcept {
+constexpr ::NPrivate::TSteppedXRange<T> xrange(T start, T finish, decltype(T() - T()) step) {
     return {start, finish, step};
 }
 
+/// generate arithmetic progression with step known at compile time, e.g. xrange<4>(0, n)
+template <auto Step, typename T>
+constexpr ::NPrivate::TSteppedXRange<T, Step> xrange(T start, T finish) noexcept {
+    static_assert(Step != 0, "step should not be zero");
+    return {start, finish};
+}
+
 /// generate sequence [start; finish)
 template <typename T>
 constexpr ::NPrivate::TSimpleXRange<T> xrange(T start, T finish) noexcept {
@@ -1,115 +1,352 @@
 #pragma once
 
+#include "block.h"
+#include "for_each.h"
+#include "light_tuple.h"
+#include "size_hint.h"
+#include "static_extent.h"
+#include "traits.h"
+
 #include <util/generic/store_policy.h>
 
 #include <algorithm>
 #include <iterator>
+#include <stdexcept>
 #include <tuple>
 
 
 namespace NPrivate {
 
-    template <typename TContainer, typename TIteratorCategory = typename std::iterator_traits<decltype(std::begin(std::declval<TContainer>()))>::iterator_category>
-    static constexpr bool HasRandomAccessIterator(int32_t) {
-        return std::is_same_v<TIteratorCategory, std::random_access_iterator_tag>;
-    }
+    //! Value of Zip: tuple of references to elements of containers.
+    //! Differs from std::tuple in one way: rvalues of it are swappable, as std::sort and others require
+    template <typename... TReferences>
+    struct TZipReference : std::tuple<TReferences...> {
+        using TBase = std::tuple<TReferences...>;
+        using TBase::TBase;
+        using TBase::operator=;
 
-    template <typename TContainer>
-    static constexpr bool HasRandomAccessIterator(uint32_t) {
-        return false;
-    }
+        friend void swap(TZipReference a, TZipReference b) {
+            // swaps referenced elements, not the references themselves
+            a.TBase::swap(b);
+        }
+    };
 
     template <typename... TContainers>
     struct TZipper {
         template <std::size_t... I>
         struct TZipperWithIndex {
         private:
-            using THolders = std::tuple<TAutoEmbedOrPtrPolicy<TContainers>...>;
-            using TValue = std::tuple<decltype(*std::begin(std::declval<TContainers&>()))...>;
-            using TIteratorState = std::tuple<decltype(std::begin(std::declval<TContainers&>()))...>;
-            using TSentinelState = std::tuple<decltype(std::end(std::declval<TContainers&>()))...>;
+            using THolders = TLightTuple<TAutoEmbedOrPtrPolicy<TContainers>...>;
+            using TValue = TZipReference<decltype(*std::begin(std::declval<TContainers&>()))...>;
+            using TDecayedValue = std::tuple<std::decay_t<decltype(*std::begin(std::declval<TContainers&>()))>...>;
+            using TIteratorState = TLightTuple<decltype(std::begin(std::declval<TContainers&>()))...>;
+            using TSentinelState = TLightTuple<decltype(std::end(std::declval<TContainers&>()))...>;
 
             static constexpr bool TrivialSentinel = std::is_same_v<TIteratorState, TSentinelState>;
 
             struct TIterator;
-            struct TSentinelCandidate {
+            struct TNoStepsBack {
+            };
+            struct TSentinelCandidate : TNoStepsBack {
                 TSentinelState Iterators_;
             };
             using TSentinel = std::conditional_t<TrivialSentinel, TIterator, TSentinelCandidate>;
 
+        public:
 #ifndef _WINDOWS
             // windows compiler crashes here
-            static constexpr bool LimitByFirstContainer = TrivialSentinel &&
+            //! Iterator keeps begins of the containers and one index
+            static constexpr bool RandomAccess = TrivialSentinel &&
                 ((HasRandomAccessIterator<TContainers>(0)) && ...);
 #else
-            static constexpr bool LimitByFirstContainer = false;
+            static constexpr bool RandomAccess = false;
 #endif
+            //! Length is known before iteration, so iterators are compared by index only
+            static constexpr bool Sized = RandomAccess || (TrivialSentinel && (HasSize<TContainers>(0) && ...));
+            //! end() is aligned to the shortest container, so reverse iteration starts from the last common element
+            static constexpr bool Bidirectional = RandomAccess || (Sized && (HasBidirectionalIterator<TContainers>(0) && ...));
+            //! The shortest of the inputs if all of them are known at compile time
+            static constexpr std::size_t Extent = MinExtent<TContainers...>();
 
-            struct TIterator {
+        private:
+            //! end() keeps the ends of the containers and the longer ones are stepped back to the common length
+            //! on the first decrement, so end() is O(1) and loops comparing with it stay linear
+            static constexpr bool LazyEnd = Bidirectional && !RandomAccess;
+            struct TPendingStepsBack {
+                std::ptrdiff_t StepsBack_[sizeof...(I)] = {};
+            };
+
+            struct TIterator : std::conditional_t<LazyEnd, TPendingStepsBack, TNoStepsBack> {
                 using difference_type = std::ptrdiff_t;
-                using value_type = TValue;
+                using value_type = TDecayedValue;
                 using pointer = TValue*;
-                using reference = TValue&;
-                using iterator_category = std::input_iterator_tag;
+                using reference = TValue;
+                using iterator_category = std::conditional_t<RandomAccess, std::random_access_iterator_tag,
+                    std::conditional_t<Bidirectional, std::bidirectional_iterator_tag, std::input_iterator_tag>>;
 
-                TValue operator*() {
-                    return {*std::get<I>(Iterators_)...};
+                constexpr TValue operator*() {
+                    if constexpr (RandomAccess) {
+                        return {*(Get<I>(Iterators_) + Index_)...};
+                    } else {
+                        return {*Get<I>(Iterators_)...};
+                    }
+                }
+                constexpr TValue operator*() const {
+                    if constexpr (RandomAccess) {
+                        return {*(Get<I>(Iterators_) + Index_)...};
+                    } else {
+                        return {*Get<I>(Iterators_)...};
+                    }
+                }
+                constexpr TIterator& operator++() {
+                    if constexpr (RandomAccess) {
+                        ++Index_;
+                    } else if constexpr (Sized) {
+                        ++Index_;
+                        (++Get<I>(Iterators_), ...);
+                    } else {
+                        (++Get<I>(Iterators_), ...);
+                    }
+                    return *this;
                 }
-                void operator++() {
-                    (++std::get<I>(Iterators_), ...);
+                constexpr TIterator operator++(int) {
+                    TIterator result = *this;
+                    ++*this;
+                    return result;
                 }
-                bool operator!=(const TSentinel& other) const {
-                    if constexpr (LimitByFirstContainer) {
-                        return std::get<0>(Iterators_) != std::get<0>(other.Iterators_);
+                constexpr bool operator!=(const TSentinel& other) const {
+                    if constexpr (Sized) {
+                        return Index_ != other.Index_;
                     } else {
                         // yes, for all correct iterators but end() it is a correct way to compare
-                        return ((std::get<I>(Iterators_) != std::get<I>(other.Iterators_)) && ...);
+                        return ((Get<I>(Iterators_) != Get<I>(other.Iterators_)) && ...);
                     }
                 }
-                bool operator==(const TSentinel& other) const {
+                constexpr bool operator==(const TSentinel& other) const {
                     return !(*this != other);
                 }
 
+                constexpr TIterator& operator--() {
+                    static_assert(Bidirectional);
+                    --Index_;
+                    if constexpr (LazyEnd) {
+                        ((Get<I>(Iterators_) = std::prev(Get<I>(Iterators_), this->StepsBack_[I] + 1), this->StepsBack_[I] = 0), ...);
+                    } else if constexpr (!RandomAccess) {
+                        (--Get<I>(Iterators_), ...);
+                    }
+                    return *this;
+                }
+                constexpr TIterator operator--(int) {
+                    TIterator result = *this;
+                    --*this;
+                    return result;
+                }
+
+                // random access part, Iterators_ are begins of containers here
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr TValue operator[](difference_type n) const {
+                    return {*(Get<I>(Iterators_) + (Index_ + n))...};
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr TIterator& operator+=(difference_type n) {
+                    Index_ += n;
+                    return *this;
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr TIterator& operator-=(difference_type n) {
+                    return *this += -n;
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr TIterator operator+(difference_type n) const {
+                    TIterator result = *this;
+                    return result += n;
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                friend constexpr TIterator operator+(difference_type n, const TIterator& iterator) {
+                    return iterator + n;
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr TIterator operator-(difference_type n) const {
+                    TIterator result = *this;
+                    return result -= n;
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr difference_type operator-(const TIterator& other) const {
+                    return Index_ - other.Index_;
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr bool operator<(const TIterator& other) const {
+                    return Index_ < other.Index_;
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr bool operator>(const TIterator& other) const {
+                    return Index_ > other.Index_;
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr bool operator<=(const TIterator& other) const {
+                    return Index_ <= other.Index_;
+                }
+                template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+                constexpr bool operator>=(const TIterator& other) const {
+                    return Index_ >= other.Index_;
+                }
+
                 TIteratorState Iterators_;
+                difference_type Index_ = 0;
             };
+
+            //! Length of the shortest container
+            constexpr std::ptrdiff_t CalcSize() const {
+                static_assert(Sized);
+                if constexpr (Extent != DynamicExtent) {
+                    return Extent;
+                } else if constexpr (RandomAccess) {
+                    return std::min({std::ptrdiff_t(
+                        std::end(*Get<I>(Holders_).Ptr()) - std::begin(*Get<I>(Holders_).Ptr()))...});
+                } else {
+                    return std::min({std::ptrdiff_t(std::size(*Get<I>(Holders_).Ptr()))...});
+                }
+            }
+
         public:
             using iterator = TIterator;
             using const_iterator = TIterator;
+            using value_type = TDecayedValue;
+            using reference = TValue;
+            using difference_type = std::ptrdiff_t;
+            using size_type = std::size_t;
 
-            TIterator begin() const {
-                return {TIteratorState{std::begin(*std::get<I>(Holders_).Ptr())...}};
+            constexpr TIterator begin() const {
+                return {{}, TIteratorState{std::begin(*Get<I>(Holders_).Ptr())...}};
             }
 
-            TSentinel end() const {
-                if constexpr (LimitByFirstContainer) {
-                    auto endOfFirst = std::begin(*std::get<0>(Holders_).Ptr()) + std::min({
-                        std::end(*std::get<I>(Holders_).Ptr()) - std::begin(*std::get<I>(Holders_).Ptr())...});
-                    TIterator iter{TSentinelState{std::end(*std::get<I>(Holders_).Ptr())...}};
-                    std::get<0>(iter.Iterators_) = endOfFirst;
-                    return iter;
+            constexpr TSentinel end() const {
+                if constexpr (RandomAccess) {
+                    return {{}, TIteratorState{std::begin(*Get<I>(Holders_).Ptr())...}, CalcSize()};
+                } else if constexpr (LazyEnd) {
+                    // longer containers are stepped back to the length of the shortest one by the first decrement
+                    const auto size = CalcSize();
+                    return {{{(std::ptrdiff_t(std::size(*Get<I>(Holders_).Ptr())) - size)...}},
+                        TSentinelState{std::end(*Get<I>(Holders_).Ptr())...}, size};
+                } else if constexpr (Sized) {
+                    return {{}, TSentinelState{std::end(*Get<I>(Holders_).Ptr())...}, CalcSize()};
                 } else {
-                    return {TSentinelState{std::end(*std::get<I>(Holders_).Ptr())...}};
+                    return {{}, TSentinelState{std::end(*Get<I>(Holders_).Ptr())...}};
                 }
             }
 
-            mutable THolders Holders_;
+            //! Declared only when the length is known before iteration, so HasSize of outer adaptors is not misled
+            template <bool S = Sized, std::enable_if_t<S, int> = 0>
+            constexpr size_type size() const {
+                return CalcSize();
+            }
+
+            template <bool S = Sized, std::enable_if_t<S, int> = 0>
+            constexpr bool empty() const {
+                return !(begin() != end());
+            }
+
+            template <bool RA = RandomAccess, std::enable_if_t<RA, int> = 0>
+            constexpr TValue operator[](size_type at) const {
+                return {*(std::begin(*Get<I>(Holders_).Ptr()) + at)...};
+            }
+
+            //! The shortest of the inputs
+            TSizeHint SizeHint() const {
+                TSizeHint hint = ::SizeHint(*Get<0>(Holders_).Ptr());
+                ((hint = TSizeHint::Min(hint, ::SizeHint(*Get<I>(Holders_).Ptr()))), ...);
+                return hint;
+            }
+
+            template <typename TFunction>
+            void ForEach(TFunction&& fn) const {
+                if constexpr (RandomAccess) {
+                    // one induction variable instead of comparing iterators of every container
+                    const auto size = CalcSize();
+                    const TIteratorState begins{std::begin(*Get<I>(Holders_).Ptr())...};
+                    for (std::ptrdiff_t j = 0; j < size; ++j) {
+                        fn(TValue{*(Get<I>(begins) + j)...});
+                    }
+                } else {
+                    for (auto it = begin(), last = end(); it != last; ++it) {
+                        fn(*it);
+                    }
+                }
+            }
+
+            //! Columns are filled in lockstep when all the inputs fill every row
+            auto BlockReader() const {
+                using TInputs = std::tuple<decltype(::BlockReader(*Get<I>(Holders_).Ptr()))...>;
+                if constexpr ((std::tuple_element_t<I, TInputs>::Dense && ...)) {
+                    return TZipBlockReader<TValue, std::tuple_element_t<I, TInputs>...>{{::BlockReader(*Get<I>(Holders_).Ptr())...}};
+                } else {
+                    return IteratorBlockReader(*this);
+                }
+            }
+
+            THolders Holders_;
         };
 
         template <std::size_t... I>
-        static auto Zip(TContainers&&... containers, std::index_sequence<I...>) {
+        static constexpr auto Zip(TContainers&&... containers, std::index_sequence<I...>) {
             return TZipperWithIndex<I...>{{std::forward<TContainers>(containers)...}};
         }
     };
 
+    //! Length of the container if it is known before iteration, -1 otherwise
+    template <typename TContainer>
+    constexpr std::ptrdiff_t KnownSize(TContainer& container) {
+        if constexpr (HasSize<TContainer>(0)) {
+            return std::ptrdiff_t(std::size(container));
+        } else if constexpr (HasRandomAccessRange<TContainer>()) {
+            return std::end(container) - std::begin(container);
+        } else {
+            return -1;
+        }
+    }
+
+}
+
+
+namespace std {
+    template <typename... TReferences>
+    struct tuple_size<NPrivate::TZipReference<TReferences...>> : tuple_size<tuple<TReferences...>> {
+    };
+
+    template <std::size_t Index, typename... TReferences>
+    struct tuple_element<Index, NPrivate::TZipReference<TReferences...>> : tuple_element<Index, tuple<TReferences...>> {
+    };
 }
 
 
 //! Acts as pythonic zip, BUT result length is equal to shortest length of input containers
+//! Random access when all the containers are random access
 //! Usage: for (auto [ai, bi, ci] : Zip(a, b, c)) {...}
 template <typename... TContainers>
-auto Zip(TContainers&&... containers) {
+constexpr auto Zip(TContainers&&... containers) {
     return NPrivate::TZipper<TContainers...>::Zip(
         std::forward<TContainers>(containers)...,
         std::make_index_sequence<sizeof...(TContainers)>{}
     );
 }
+
+//! Zip of containers of the same length: inputs with different static extents (std::array, C arrays) do not compile,
+//! other inputs of known length (std::vector, Range, ...) throw std::invalid_argument if their lengths differ.
+//! Lengths of inputs that are known only after iteration (Filter, ...) are not checked
+//! Usage: for (auto [pi, qi] : ZipEqual(p, q)) {...}
+template <typename... TContainers>
+constexpr auto ZipEqual(TContainers&&... containers) {
+    static_assert(NPrivate::SameStaticExtents<TContainers...>(), "ZipEqual of containers with different static extents");
+    if constexpr (((NPrivate::StaticExtent<TContainers>() == NPrivate::DynamicExtent) || ...)) {
+        const std::ptrdiff_t sizes[] = {NPrivate::KnownSize(containers)...};
+        std::ptrdiff_t first = -1;
+        for (std::ptrdiff_t size : sizes) {
+            if (first < 0) {
+                first = size;
+            } else if (size >= 0 && size != first) {
+                throw std::invalid_argument("ZipEqual of containers with different lengths");
+            }
+        }
+    }
+    return Zip(std::forward<TContainers>(containers)...);
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+/** @file
+ * Realisation over C++20 standard ranges: Map, Filter, Reversed and Range are std::views,
+ * Concatenate is views::join over an array of views.
+ * Zip and CartesianProduct are not in C++20, so they are small views below (Enumerate is Zip with views::iota).
+ * Requires -std=c++20.
+ */
+
+namespace NFuncTools::NPrivate {
+
+    template <typename... TViews>
+    static constexpr bool AllForward = (std::ranges::forward_range<TViews> && ...);
+
+    //! Shim for std::views::zip of C++23, length is equal to the shortest input
+    template <typename... TViews>
+    class TZipView : public std::ranges::view_interface<TZipView<TViews...>> {
+        struct TSentinel {
+            std::tuple<std::ranges::sentinel_t<TViews>...> Ends_;
+        };
+
+    public:
+        class TIterator {
+        public:
+            //! Value type is a tuple of references too: C++20 has no common reference of tuples
+            using value_type = std::tuple<std::ranges::range_reference_t<TViews>...>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::conditional_t<AllForward<TViews...>,
+                std::forward_iterator_tag, std::input_iterator_tag>;
+
+            TIterator() = default;
+
+            explicit TIterator(std::tuple<std::ranges::iterator_t<TViews>...> iterators)
+                : Iterators_(std::move(iterators))
+            {
+            }
+
+            value_type operator*() const {
+                return std::apply([](const auto&... iterator) { return value_type(*iterator...); }, Iterators_);
+            }
+
+            TIterator& operator++() {
+                std::apply([](auto&... iterator) { (++iterator, ...); }, Iterators_);
+                return *this;
+            }
+
+            auto operator++(int) {
+                if constexpr (AllForward<TViews...>) {
+                    TIterator result = *this;
+                    ++*this;
+                    return result;
+                } else {
+                    ++*this;
+                }
+            }
+
+            bool operator==(const TIterator& other) const
+                requires AllForward<TViews...>
+            {
+                return Iterators_ == other.Iterators_;
+            }
+
+            friend bool operator==(const TIterator& iterator, const TSentinel& sentinel) {
+                return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return ((std::get<I>(iterator.Iterators_) == std::get<I>(sentinel.Ends_)) || ...);
+                }(std::index_sequence_for<TViews...>{});
+            }
+
+        private:
+            std::tuple<std::ranges::iterator_t<TViews>...> Iterators_;
+        };
+
+        TZipView() = default;
+
+        explicit TZipView(TViews... views)
+            : Views_(std::move(views)...)
+        {
+        }
+
+        TIterator begin() {
+            return TIterator{std::apply([](auto&... view) { return std::tuple{std::ranges::begin(view)...}; }, Views_)};
+        }
+
+        TSentinel end() {
+            return {std::apply([](auto&... view) { return std::tuple{std::ranges::end(view)...}; }, Views_)};
+        }
+
+    private:
+        std::tuple<TViews...> Views_;
+    };
+
+    //! Shim for std::views::cartesian_product of C++23, the last input changes the fastest
+    template <typename... TViews>
+    class TCartesianProductView : public std::ranges::view_interface<TCartesianProductView<TViews...>> {
+        static_assert(AllForward<TViews...>, "CartesianProduct iterates inputs several times");
+
+    public:
+        class TIterator {
+        public:
+            using value_type = std::tuple<std::ranges::range_reference_t<TViews>...>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::forward_iterator_tag;
+
+            TIterator() = default;
+
+            TIterator(TCartesianProductView* parent, std::tuple<std::ranges::iterator_t<TViews>...> iterators, bool finished)
+                : Parent_(parent)
+                , Iterators_(std::move(iterators))
+                , Finished_(finished)
+            {
+            }
+
+            value_type operator*() const {
+                return std::apply([](const auto&... iterator) { return value_type(*iterator...); }, Iterators_);
+            }
+
+            TIterator& operator++() {
+                Finished_ = Increment<sizeof...(TViews) - 1>();
+                return *this;
+            }
+
+            TIterator operator++(int) {
+                TIterator result = *this;
+                ++*this;
+                return result;
+            }
+
+            bool operator==(const TIterator& other) const {
+                return Finished_ == other.Finished_ && (Finished_ || Iterators_ == other.Iterators_);
+            }
+
+            friend bool operator==(const TIterator& iterator, std::default_sentinel_t) {
+                return iterator.Finished_;
+            }
+
+        private:
+            //! Return value is true when iteration is finished
+            template <std::size_t position>
+            bool Increment() {
+                auto& iterator = std::get<position>(Iterators_);
+                auto& view = std::get<position>(Parent_->Views_);
+                if (++iterator != std::ranges::end(view)) {
+                    return false;
+                }
+                iterator = std::ranges::begin(view);
+                if constexpr (position == 0) {
+                    return true;
+                } else {
+                    return Increment<position - 1>();
+                }
+            }
+
+            TCartesianProductView* Parent_ = nullptr;
+            std::tuple<std::ranges::iterator_t<TViews>...> Iterators_;
+            bool Finished_ = true;
+        };
+
+        TCartesianProductView() = default;
+
+        explicit TCartesianProductView(TViews... views)
+            : Views_(std::move(views)...)
+        {
+        }
+
+        TIterator begin() {
+            const bool empty = std::apply([](auto&... view) { return (std::ranges::empty(view) || ...); }, Views_);
+            return {this, std::apply([](auto&... view) { return std::tuple{std::ranges::begin(view)...}; }, Views_), empty};
+        }
+
+        std::default_sentinel_t end() const {
+            return std::default_sentinel;
+        }
+
+    private:
+        std::tuple<TViews...> Views_;
+    };
+
+    struct TTupleRecursiveFlattener {
+
+        template <class TObject, std::size_t... I>
+        auto FlattenTuple(TObject&& object, std::index_sequence<I...>) const {
+            return std::tuple_cat(Flatten(std::get<I>(std::forward<TObject>(object)), 0u)...);
+        }
+
+        template <class TObject,
+                  size_t Size = std::tuple_size<typename std::decay<TObject>::type>::value>
+        auto Flatten(TObject&& object, uint32_t) const {
+            auto indexes = std::make_index_sequence<Size>{};
+            return FlattenTuple(std::forward<TObject>(object), indexes);
+        }
+
+        template <class TObject>
+        auto Flatten(TObject&& object, char) const {
+            return std::tuple<TObject>(std::forward<TObject>(object));
+        }
+
+        template <class TObject>
+        auto operator()(TObject&& object) const {
+            return Flatten(std::forward<TObject>(object), 0u);
+        }
+
+    };
+}
+
+namespace NFuncTools {
+    //! Acts as pythonic zip, BUT result length is equal to shortest lenght of input containers
+    //! Usage: for (auto [ai, bi, ci] : Zip(a, b, c)) {...}
+    template <typename... TContainers>
+    auto Zip(TContainers&&... containers) {
+        return NPrivate::TZipView<std::views::all_t<TContainers>...>(std::views::all(std::forward<TContainers>(containers))...);
+    }
+
+    //! Usage: for (auto [i, x] : Enumerate(container)) {...}
+    template <typename TContainerOrRef>
+    auto Enumerate(TContainerOrRef&& container) {
+        return Zip(std::views::iota(std::size_t(0)), std::forward<TContainerOrRef>(container));
+    }
+
+    template <typename TContainerOrRef>
+    auto Reversed(TContainerOrRef&& container) {
+        return std::forward<TContainerOrRef>(container) | std::views::reverse;
+    }
+
+    template <typename TValue>
+    auto Range(TValue from, TValue to, TValue step) {
+        // views::stride is C++23
+        const TValue count = from < to ? (to - from + step - 1) / step : TValue(0);
+        return std::views::iota(TValue(0), count) | std::views::transform([from, step](TValue i) { return from + i * step; });
+    }
+
+    template <typename TValue>
+    auto Range(TValue from, TValue to) {
+        return std::views::iota(from, std::max(from, to));
+    }
+
+    template <typename TValue>
+    auto Range(TValue to) {
+        return Range(TValue{0}, to);
+    }
+
+    //! Usage: for (i32 x : Map([](i32 x) { return x * x; }, a)) {...}
+    template <typename TMapper, typename TContainerOrRef>
+    auto Map(TMapper&& mapper, TContainerOrRef&& container) {
+        return std::forward<TContainerOrRef>(container) | std::views::transform(std::forward<TMapper>(mapper));
+    }
+
+    //! Usage: for (auto i : Map<int>(floats)) {...}
+    template <typename TMapResult, typename TContainerOrRef>
+    auto Map(TContainerOrRef&& container) {
+        return Map([](const auto& x) { return TMapResult(x); }, std::forward<TContainerOrRef>(container));
+    }
+
+    //! Usage: for (i32 x : Filter(predicate, container)) {...}
+    template <typename TPredicate, typename TContainerOrRef>
+    auto Filter(TPredicate&& predicate, TContainerOrRef&& container) {
+        return std::forward<TContainerOrRef>(container) | std::views::filter(std::forward<TPredicate>(predicate));
+    }
+
+    //! Usage: for (auto [ai, bi] : CartesianProduct(a, b)) {...}
+    //! Equivalent: for (auto& ai : a) { for (auto& bi : b) {...} }
+    template <typename... TContainers>
+    auto CartesianProduct(TContainers&&... containers) {
+        return NPrivate::TCartesianProductView<std::views::all_t<TContainers>...>(std::views::all(std::forward<TContainers>(containers))...);
+    }
+
+    //! views::join over an array of views, so all containers should have the same type of view
+    //! Usage: for (auto x : Concatenate(a, b)) {...}
+    template <typename TFirstContainer, typename... TContainers>
+    auto Concatenate(TFirstContainer&& container, TContainers&&... containers) {
+        static_assert((std::is_same_v<std::views::all_t<TFirstContainer>, std::views::all_t<TContainers>> && ...),
+                      "views::join needs views of the same type");
+        return std::array{std::views::all(std::forward<TFirstContainer>(container)),
+                          std::views::all(std::forward<TContainers>(containers))...} | std::views::join;
+    }
+
+    //! Usage: for (auto [i, ai, bi] : Flatten(Enumerate(Zip(a, b))) {...}
+    template <typename TContainerOrRef>
+    auto Flatten(TContainerOrRef&& container) {
+        return Map(NPrivate::TTupleRecursiveFlattener{}, std::forward<TContainerOrRef>(container));
+    }
+
+}
@@ -2,12 +2,17 @@
 
 #define Y_UNUSED(x) ((void) x);
 
-#if !defined(native_REALISATION) && (defined(clang) || !defined(think_cell_REALISATION))
+#if !defined(native_REALISATION) && !defined(native_simd_REALISATION) && (defined(clang) || !defined(think_cell_REALISATION))
 
 #include <functools.h>
 
-#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <optional>
 #include <set>
+#include <string>
+#include <vector>
 
 using namespace NFuncTools;
 
@@ -63,7 +68,7 @@ void TestViewCompileability(TContainerObjOrRef&& container) {
     // std compatibility
     ToVector(container);
 
-    #if !defined(boost_range_REALISATION) && !defined(think_cell_REALISATION) && !defined(range_v3_REALISATION) && !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION)
+    #if !defined(boost_range_REALISATION) && !defined(think_cell_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION)
     // const iterators
     [](const auto& cont) {
         auto constBeginIterator = cont.begin();
@@ -76,7 +81,7 @@ void TestViewCompileability(TContainerObjOrRef&& container) {
 }
 
 
-#if !defined(boost_range_REALISATION) && !defined(think_cell_REALISATION) && !defined(range_v3_REALISATION) && !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION)
+#if !defined(boost_range_REALISATION) && !defined(think_cell_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION)
 struct TTestSentinel {};
 struct TTestIterator {
     int operator*() {
@@ -148,7 +153,7 @@ TEST_F(TestFunctools, Range3) {
 }
 #endif
 
-#if !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+#if !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(think_cell_REALISATION)
 TEST_F(TestFunctools, CompileRange) {
     TestViewCompileability(Range(19));
     TestViewCompileability(Range(10, 19));
@@ -201,7 +206,7 @@ TEST_F(TestFunctools, EnumerateTemporary) {
 }
 #endif
 
-#if !defined(boost_range_REALISATION) && !defined(think_cell_REALISATION) && !defined(range_v3_REALISATION) && !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION)
+#if !defined(boost_range_REALISATION) && !defined(think_cell_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION)
 TEST_F(TestFunctools, CompileEnumerate) {
     auto container = std::vector{1, 2, 3};
     TestViewCompileability(Enumerate(container));
@@ -221,10 +226,62 @@ TEST_F(TestFunctools, CompileEnumerate) {
 }
 #endif
 
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, EnumerateRandomAccess) {
+    std::vector a = {10, 11, 12, 13};
+    auto enumerated = Enumerate(a);
+    static_assert(decltype(enumerated)::RandomAccess);
+    ASSERT_TRUE((std::is_same_v<decltype(enumerated)::iterator::iterator_category, std::random_access_iterator_tag>));
+    ASSERT_EQ(enumerated.size(), 4u);
+    ASSERT_EQ(enumerated.end() - enumerated.begin(), 4);
+    ASSERT_EQ(std::get<0>(enumerated[2]), 2u);
+    ASSERT_EQ(std::get<1>(enumerated[2]), 12);
+    ASSERT_EQ(std::get<0>(*(enumerated.end() - 1)), 3u);
+
+    auto narrow = Enumerate<uint32_t>(a, 5);
+    static_assert(std::is_same_v<std::decay_t<decltype(std::get<0>(*narrow.begin()))>, uint32_t>);
+    std::vector<std::pair<uint32_t, int>> res;
+    for (auto [i, x] : narrow) {
+        res.push_back({i, x});
+    }
+    ASSERT_EQ(res, (std::vector<std::pair<uint32_t, int>>{{5, 10}, {6, 11}, {7, 12}, {8, 13}}));
+    ASSERT_EQ(std::get<0>(*(narrow.begin() + 3)), 8u);
+    ForEach(narrow, [](auto t) {
+        auto [i, x] = t;
+        ASSERT_EQ(i + 5, (uint32_t)x);
+    });
+
+    // indexes are kept while iterator walks in any direction
+    auto it = Enumerate(Range(100)).begin() + 50;
+    it -= 10;
+    --it;
+    ASSERT_EQ(std::get<0>(*it), 39u);
+    ASSERT_EQ(std::get<1>(*it), 39);
+
+    std::set<int> c = {3, 2, 1};
+    auto enumeratedSet = Enumerate(c, 1);
+    static_assert(!decltype(enumeratedSet)::RandomAccess);
+    ASSERT_EQ(enumeratedSet.size(), 3u);
+    for (auto [i, x] : enumeratedSet) {
+        ASSERT_EQ(i, x);
+    }
+
+    // not sized: an outer Zip iterates it by iterators
+    std::list<int> list = {1, 2, 3, 4};
+    auto isOdd = [](int x) { return x % 2 == 1; };
+    static_assert(!NPrivate::HasSize<decltype(Enumerate(Filter(isOdd, list)))>(0));
+    std::vector<std::pair<std::size_t, int>> zipped;
+    for (auto [enumerated, l] : Zip(Enumerate(Filter(isOdd, list)), list)) {
+        zipped.push_back({std::get<0>(enumerated), std::get<1>(enumerated) * 10 + l});
+    }
+    ASSERT_EQ(zipped, (std::vector<std::pair<std::size_t, int>>{{0, 11}, {1, 32}}));
+}
+#endif
+
 TEST_F(TestFunctools, Zip) {
     std::vector<std::pair<std::vector<int32_t>, std::vector<int32_t>>> ts = {
         {{1, 2, 3}, {4, 5, 6}},
-        #if !defined(boost_range_REALISATION) && !defined(think_cell_REALISATION) && !defined(ordinary_view_REALISATION)
+        #if !defined(boost_range_REALISATION) && !defined(think_cell_REALISATION)
         {{1, 2, 3}, {4, 5, 6, 7}},
         {{1, 2, 3, 4}, {4, 5, 6}},
         {{1, 2, 3, 4}, {}},
@@ -232,7 +289,7 @@ TEST_F(TestFunctools, Zip) {
     };
 
     for (auto [a, b] : ts) {
-        #if !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION)
+        #if !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION)
         {
             int k = 0;
             for (const auto& [i, j] : Zip(a, std::vector<int32_t>(b))) {
@@ -284,7 +341,7 @@ TEST_F(TestFunctools, ZipReference) {
 TEST_F(TestFunctools, Zip3) {
     std::vector<std::tuple<std::vector<int32_t>, std::vector<int32_t>, std::vector<int32_t>>> ts = {
         {{1, 2, 3}, {4, 5, 6}, {11, 3, 9}},
-        #if !defined(think_cell_REALISATION) && !defined(ordinary_view_REALISATION)
+        #if !defined(think_cell_REALISATION)
         {{1, 2, 3}, {4, 5, 6}, {11, 3}},
         {{1, 2, 3}, {4, 5, 6, 7}, {9, 0}},
         {{1, 2, 3, 4}, {9}, {4, 5, 6}},
@@ -309,7 +366,7 @@ TEST_F(TestFunctools, Zip3) {
 }
 #endif
 
-#if !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+#if !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(think_cell_REALISATION)
 TEST_F(TestFunctools, CompileZip) {
     auto container = std::vector{1, 2, 3};
     TestViewCompileability(Zip(container));
@@ -332,6 +389,71 @@ TEST_F(TestFunctools, CompileZip) {
 }
 #endif
 
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, ZipRandomAccess) {
+    std::vector keys = {5, 3, 4, 1, 2, 7};
+    std::vector<std::string> values = {"e", "c", "d", "a", "b"};
+    auto zipped = Zip(keys, values);
+    static_assert(decltype(zipped)::RandomAccess);
+    ASSERT_TRUE((std::is_same_v<decltype(zipped)::iterator::iterator_category, std::random_access_iterator_tag>));
+    ASSERT_EQ(zipped.size(), 5u);
+    ASSERT_EQ(zipped.end() - zipped.begin(), 5);
+    ASSERT_EQ(std::get<1>(zipped[3]), "a");
+    ASSERT_EQ(std::get<0>(*(zipped.begin() + 2)), 4);
+    ASSERT_EQ(std::get<0>((zipped.end() - 1)[0]), 2);
+    ASSERT_TRUE(zipped.begin() < zipped.end());
+
+    std::sort(zipped.begin(), zipped.end());
+    ASSERT_EQ(keys, (std::vector{1, 2, 3, 4, 5, 7}));
+    ASSERT_EQ(values, (std::vector<std::string>{"a", "b", "c", "d", "e"}));
+
+    std::vector weights = {0.5, 0.1, 0.3, 0.2, 0.4};
+    std::vector ids = {0, 1, 2, 3, 4};
+    auto byWeight = Zip(weights, ids);
+    std::nth_element(byWeight.begin(), byWeight.begin() + 2, byWeight.end());
+    ASSERT_EQ(weights[2], 0.3);
+    ASSERT_EQ(ids[2], 2);
+
+    // sized, but not random access
+    std::list<int> list = {1, 2, 3, 4};
+    auto zippedList = Zip(list, keys);
+    static_assert(!decltype(zippedList)::RandomAccess && decltype(zippedList)::Sized);
+    ASSERT_EQ(zippedList.size(), 4u);
+    std::vector<std::pair<int, int>> res;
+    for (auto [l, k] : zippedList) {
+        res.push_back({l, k});
+    }
+    ASSERT_EQ(res, (std::vector<std::pair<int, int>>{{1, 1}, {2, 2}, {3, 3}, {4, 4}}));
+    ASSERT_EQ(Zip(list, std::vector<int>{}).size(), 0u);
+    ASSERT_TRUE(Zip(list, std::vector<int>{}).empty());
+
+    // end() of lists of different lengths keeps their ends, the first decrement aligns them
+    std::list<int> longer = {10, 20, 30, 40, 50, 60};
+    auto zippedLists = Zip(longer, list);
+    std::size_t steps = 0;
+    for (auto it = zippedLists.begin(); it != zippedLists.end(); ++it) {
+        ++steps;
+    }
+    ASSERT_EQ(steps, 4u);
+    auto last = zippedLists.end();
+    ASSERT_EQ(std::get<0>(*--last), 40);
+    ASSERT_EQ(std::get<1>(*last), 4);
+    ASSERT_EQ(std::get<0>(*--last), 30);
+    ASSERT_EQ(std::get<0>(*std::prev(zippedLists.end(), 4)), 10);
+
+    // not sized: size() is not declared, so an outer Zip does not take the inner one for sized
+    auto isEven = [](int x) { return x % 2 == 0; };
+    auto nested = Zip(Zip(Filter(isEven, list), keys), list);
+    static_assert(!NPrivate::HasSize<decltype(Zip(Filter(isEven, list), keys))>(0));
+    static_assert(!decltype(nested)::Sized);
+    std::vector<int> nestedKeys;
+    for (auto [inner, l] : nested) {
+        nestedKeys.push_back(std::get<1>(inner) * 10 + l);
+    }
+    ASSERT_EQ(nestedKeys, (std::vector<int>{11, 22}));
+}
+#endif
+
 TEST_F(TestFunctools, Filter) {
     std::vector<std::vector<int32_t>> ts = {
         {},
@@ -359,7 +481,7 @@ TEST_F(TestFunctools, Filter) {
 
         ASSERT_EQ(b, c);
     }
-    #if !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+    #if !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(think_cell_REALISATION)
     std::vector c = {2, 3, 4};
     auto pp = [i = int(0)](auto& x) mutable { return ++i < 2; };
     const auto f = Filter(std::move(pp), c);
@@ -370,7 +492,113 @@ TEST_F(TestFunctools, Filter) {
 }
 
 
-#if !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, FilterBlockMask) {
+    auto isOdd = [](int32_t x) { return bool(x & 1); };
+    auto isBig = [](double x) { return x > 0.5; };
+    static_assert(decltype(FilterBlockMask(isOdd, std::declval<std::vector<int32_t>&>()))::BlockMask);
+    static_assert(decltype(FilterBlockMask(isOdd, std::declval<const int32_t(&)[3]>()))::BlockMask);
+    static_assert(!decltype(FilterBlockMask(isOdd, std::declval<std::set<int32_t>&>()))::BlockMask);
+    static_assert(!decltype(FilterBlockMask(isOdd, std::declval<std::vector<std::string>&>()))::BlockMask);
+    static_assert(!decltype(Filter(isOdd, std::declval<std::vector<int32_t>&>()))::BlockMask);
+
+    for (size_t size : {0, 1, 63, 64, 65, 128, 200, 1000}) {
+        std::vector<int32_t> a(size);
+        std::vector<double> b(size);
+        for (size_t i = 0; i < size; ++i) {
+            a[i] = (i * 7919) ^ (i >> 3);
+            b[i] = double((i * 31) % 97) / 97;
+        }
+        // long runs without matches
+        for (size_t i = size / 3; i < size / 2; ++i) {
+            a[i] = 0;
+        }
+
+        std::vector<int32_t> expectedA;
+        std::copy_if(a.begin(), a.end(), std::back_inserter(expectedA), isOdd);
+        std::vector<double> expectedB;
+        std::copy_if(b.begin(), b.end(), std::back_inserter(expectedB), isBig);
+
+        std::vector<int32_t> pulled;
+        for (auto x : FilterBlockMask(isOdd, a)) {
+            pulled.push_back(x);
+        }
+        ASSERT_EQ(pulled, expectedA);
+
+        std::vector<int32_t> pushed;
+        ForEach(FilterBlockMask(isOdd, a), [&pushed](int32_t x) {
+            pushed.push_back(x);
+        });
+        ASSERT_EQ(pushed, expectedA);
+
+        std::vector<double> pulledB;
+        for (auto x : FilterBlockMask(isBig, b)) {
+            pulledB.push_back(x);
+        }
+        ASSERT_EQ(pulledB, expectedB);
+    }
+
+    // references to elements of the container
+    std::vector<int32_t> c = {1, 2, 3, 4};
+    for (auto& x : FilterBlockMask(isOdd, c)) {
+        x *= 10;
+    }
+    ASSERT_EQ(c, (std::vector<int32_t>{10, 2, 30, 4}));
+
+    // plain Filter calls the predicate lazily, so stateful predicates see elements as they are consumed
+    std::vector<int32_t> d = {1, 2, 1, 3, 2, 4};
+    std::set<int32_t> seen;
+    auto isNew = [&seen](int32_t x) { return seen.insert(x).second; };
+    std::vector<int32_t> unique;
+    for (auto x : Filter(isNew, d)) {
+        unique.push_back(x);
+    }
+    ASSERT_EQ(unique, (std::vector<int32_t>{1, 2, 3, 4}));
+    int calls = 0;
+    auto counted = [&calls](int32_t) { return ++calls > 0; };
+    for ([[maybe_unused]] auto x : Filter(counted, std::vector<int32_t>(100))) {
+        break;
+    }
+    ASSERT_EQ(calls, 1);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, FilterMapCallsMapperOnce) {
+    std::vector<int> a = {1, 2, 3, 4, 5, 6, 7};
+    int calls = 0;
+    auto decode = [&calls](int x) {
+        ++calls;
+        return std::to_string(x * x);
+    };
+    auto isShort = [](const std::string& s) { return s.size() == 1; };
+
+    std::vector<std::string> res;
+    for (auto s : Filter(isShort, Map(decode, a))) {
+        res.push_back(s);
+    }
+    ASSERT_EQ(res, (std::vector<std::string>{"1", "4", "9"}));
+    ASSERT_EQ(calls, (int)a.size());
+
+    calls = 0;
+    res.clear();
+    ForEach(Filter(isShort, Map(decode, a)), [&res](std::string s) {
+        res.push_back(std::move(s));
+    });
+    ASSERT_EQ(res, (std::vector<std::string>{"1", "4", "9"}));
+    ASSERT_EQ(calls, (int)a.size());
+
+    // dereferencing twice does not call mapper again
+    calls = 0;
+    auto filtered = Filter(isShort, Map(decode, a));
+    auto it = filtered.begin();
+    ASSERT_EQ(*it, "1");
+    ASSERT_EQ(*it, "1");
+    ASSERT_EQ(calls, 1);
+}
+#endif
+
+#if !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(think_cell_REALISATION)
 TEST_F(TestFunctools, CompileFilter) {
     auto container = std::vector{1, 2, 3};
     auto isOdd = [](int x) { return bool(x & 1); };
@@ -419,7 +647,7 @@ TEST_F(TestFunctools, Map) {
     ASSERT_EQ(roundedFloats, resFloat);
 }
 
-#if !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+#if !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(think_cell_REALISATION)
 TEST_F(TestFunctools, CompileMap) {
     auto container = std::vector{1, 2, 3};
     auto sqr = [](int x) { return x * x; };
@@ -429,7 +657,7 @@ TEST_F(TestFunctools, CompileMap) {
 }
 #endif
 
-#if !defined(boost_range_REALISATION) && !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+#if !defined(boost_range_REALISATION) && !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(think_cell_REALISATION)
 TEST_F(TestFunctools, MapRandomAccess) {
     auto sqr = [](int x) { return x * x; };
     {
@@ -440,7 +668,7 @@ TEST_F(TestFunctools, MapRandomAccess) {
     {
         auto container = std::set<int>{1, 2, 3};
         auto mapped = Map(sqr, container);
-        ASSERT_TRUE((std::is_same_v<decltype(mapped)::iterator::iterator_category, std::input_iterator_tag>));
+        ASSERT_TRUE((std::is_same_v<decltype(mapped)::iterator::iterator_category, std::bidirectional_iterator_tag>));
     }
 }
 #endif
@@ -513,7 +741,840 @@ TEST_F(TestFunctools, CartesianProduct3) {
 }
 #endif
 
-#if !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, CartesianProductRandomAccess) {
+    using TTuple = std::tuple<int, int, int>;
+    std::vector a = {1, 2, 3};
+    std::vector b = {10, 20};
+    std::vector c = {100, 200, 300, 400};
+    auto product = CartesianProduct(a, b, c);
+    static_assert(decltype(product)::RandomAccess);
+    ASSERT_TRUE((std::is_same_v<decltype(product)::iterator::iterator_category, std::random_access_iterator_tag>));
+    ASSERT_EQ(product.size(), 24u);
+    ASSERT_EQ(product.end() - product.begin(), 24);
+
+    std::vector<TTuple> expected;
+    for (auto ai : a) {
+        for (auto bi : b) {
+            for (auto ci : c) {
+                expected.push_back({ai, bi, ci});
+            }
+        }
+    }
+    for (size_t n = 0; n < expected.size(); ++n) {
+        ASSERT_EQ(TTuple(product[n]), expected[n]);
+        ASSERT_EQ(TTuple(*(product.begin() + n)), expected[n]);
+        ASSERT_EQ(TTuple(*(product.end() - (expected.size() - n))), expected[n]);
+    }
+
+    // walking forward and backward across all carries
+    std::vector<TTuple> backward;
+    for (auto it = product.end(); it != product.begin();) {
+        --it;
+        backward.push_back(*it);
+    }
+    std::reverse(backward.begin(), backward.end());
+    ASSERT_EQ(backward, expected);
+    auto it = product.begin();
+    for (size_t n = 0; n < expected.size(); ++n, ++it) {
+        ASSERT_EQ(TTuple(*it), expected[n]);
+    }
+    ASSERT_TRUE(it == product.end());
+    --it;
+    ASSERT_EQ(TTuple(*it), expected.back());
+
+    // resume from a checkpoint
+    std::vector<TTuple> tail(product.begin() + 17, product.end());
+    ASSERT_EQ(tail, std::vector<TTuple>(expected.begin() + 17, expected.end()));
+
+    std::vector<int> empty;
+    auto emptyProduct = CartesianProduct(a, empty, c);
+    ASSERT_EQ(emptyProduct.size(), 0u);
+    ASSERT_TRUE(emptyProduct.empty());
+    ASSERT_TRUE(emptyProduct.begin() == emptyProduct.end());
+
+    std::set<int> d = {1, 2};
+    auto inputProduct = CartesianProduct(d, a);
+    static_assert(!decltype(inputProduct)::RandomAccess);
+    ASSERT_EQ(inputProduct.size(), 6u);
+
+    // not sized: size() is not declared, so an outer Zip iterates it by iterators
+    std::list<int> list = {1, 2, 3};
+    auto isOdd = [](int x) { return x % 2 == 1; };
+    static_assert(!NPrivate::HasSize<decltype(CartesianProduct(Filter(isOdd, list), b))>(0));
+    std::vector<int> zipped;
+    for (auto [pair, l] : Zip(CartesianProduct(Filter(isOdd, list), b), list)) {
+        zipped.push_back(std::get<0>(pair) + std::get<1>(pair) + l * 1000);
+    }
+    ASSERT_EQ(zipped, (std::vector<int>{1011, 2021, 3013}));
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, CartesianProductTiled) {
+    using TPair = std::pair<int, int>;
+    std::vector<int> a(17);
+    std::vector<int> b(10);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = i;
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+        b[i] = 100 + i;
+    }
+    std::vector<TPair> expected;
+    for (auto [ai, bi] : CartesianProduct(a, b)) {
+        expected.push_back({ai, bi});
+    }
+
+    for (auto [tileA, tileB] : std::vector<TPair>{{1, 1}, {4, 3}, {5, 10}, {17, 4}, {100, 100}, {0, 0}}) {
+        auto product = CartesianProductTiled(a, b, tileA, tileB);
+        ASSERT_EQ(product.size(), expected.size());
+
+        std::vector<TPair> iterated;
+        for (auto [ai, bi] : product) {
+            iterated.push_back({ai, bi});
+        }
+        std::vector<TPair> pushed;
+        ForEach(product, [&](auto t) {
+            auto [ai, bi] = t;
+            pushed.push_back({ai, bi});
+        });
+        ASSERT_EQ(iterated, pushed);
+
+        std::sort(iterated.begin(), iterated.end());
+        ASSERT_EQ(iterated, expected);
+    }
+
+    // tiles are visited one after another
+    std::vector<TPair> tiled;
+    for (auto [ai, bi] : CartesianProductTiled(Range(4), Range(4), 2, 2)) {
+        tiled.push_back({ai, bi});
+    }
+    ASSERT_EQ(tiled, (std::vector<TPair>{
+        {0, 0}, {0, 1}, {1, 0}, {1, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3},
+        {2, 0}, {2, 1}, {3, 0}, {3, 1}, {2, 2}, {2, 3}, {3, 2}, {3, 3},
+    }));
+
+    for (auto [ai, bi] : CartesianProductTiled(a, std::vector<int>{}, 3, 3)) {
+        Y_UNUSED(ai);
+        Y_UNUSED(bi);
+        ASSERT_TRUE(false);
+    }
+    auto modified = a;
+    for (auto [ai, bi] : CartesianProductTiled(modified, b, 3, 3)) {
+        ai += bi;
+    }
+    ASSERT_EQ(modified[0], 0 + 100 * 10 + 45);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, Chunks) {
+    std::vector<int> a = {1, 2, 3, 4, 5, 6, 7};
+    using TChunks = std::vector<std::vector<int>>;
+    const TChunks expected = {{1, 2, 3}, {4, 5, 6}, {7}};
+
+    auto collect = [](auto&& chunks) {
+        TChunks result;
+        for (auto chunk : chunks) {
+            result.emplace_back(chunk.begin(), chunk.end());
+        }
+        return result;
+    };
+    auto collectPushed = [](auto&& chunks) {
+        TChunks result;
+        ForEach(chunks, [&result](auto chunk) {
+            result.emplace_back(chunk.begin(), chunk.end());
+        });
+        return result;
+    };
+
+    // zero-copy subranges
+    auto chunks = Chunks(a, 3);
+    static_assert(decltype(chunks)::RandomAccess);
+    ASSERT_EQ(chunks.size(), 3u);
+    ASSERT_EQ(&*chunks[1].begin(), &a[3]);
+    ASSERT_EQ(chunks.end() - chunks.begin(), 3);
+    ASSERT_EQ(collect(chunks), expected);
+    ASSERT_EQ(collectPushed(chunks), expected);
+    auto zipped = Chunks(Zip(a, a), 100);
+    ASSERT_EQ(zipped.size(), 1u);
+    ASSERT_EQ(zipped[0].size(), a.size());
+    ASSERT_TRUE(Chunks(std::vector<int>{}, 3).empty());
+
+    // buffered
+    std::vector<int> withOdd = {1, 2, 3, 4, 0, 5, 6, 7};
+    auto nonZero = Filter([](int x) { return x != 0; }, withOdd);
+    static_assert(!decltype(Chunks(nonZero, 3))::RandomAccess);
+    ASSERT_EQ(collect(Chunks(nonZero, 3)), expected);
+    ASSERT_EQ(collectPushed(Chunks(nonZero, 3)), expected);
+    ASSERT_EQ(collect(Chunks(Concatenate(std::vector<int>{1, 2, 3, 4}, std::vector<int>{5, 6}), 2)),
+              (TChunks{{1, 2}, {3, 4}, {5, 6}}));
+    ASSERT_EQ(collect(Chunks(Filter([](int) { return false; }, a), 3)), TChunks{});
+
+    // static size
+    auto arrays = Chunks<3>(a);
+    std::vector<std::array<int, 3>> expectedArrays = {{1, 2, 3}, {4, 5, 6}};
+    std::vector<std::array<int, 3>> got;
+    for (const std::array<int, 3>& chunk : arrays) {
+        got.push_back(chunk);
+    }
+    ASSERT_EQ(got, expectedArrays);
+    ASSERT_EQ(std::vector<int>(arrays.Remainder().begin(), arrays.Remainder().end()), std::vector<int>{7});
+
+    for (bool pushed : {false, true}) {
+        auto filteredArrays = Chunks<3>(nonZero);
+        got.clear();
+        if (pushed) {
+            ForEach(filteredArrays, [&got](const std::array<int, 3>& chunk) {
+                got.push_back(chunk);
+            });
+        } else {
+            for (const std::array<int, 3>& chunk : filteredArrays) {
+                got.push_back(chunk);
+            }
+        }
+        ASSERT_EQ(got, expectedArrays);
+        auto remainder = filteredArrays.Remainder();
+        ASSERT_EQ(std::vector<int>(remainder.begin(), remainder.end()), std::vector<int>{7});
+    }
+
+    // buffered chunks belong to their iterators
+    auto buffered = Chunks(nonZero, 3);
+    auto first = buffered.begin();
+    auto second = buffered.begin();
+    ++second;
+    ASSERT_FALSE(buffered.empty());
+    ASSERT_EQ(std::vector<int>((*first).begin(), (*first).end()), expected[0]);
+    ASSERT_EQ(std::vector<int>((*second).begin(), (*second).end()), expected[1]);
+
+    ASSERT_THROW(Chunks(a, 0), std::invalid_argument);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, ParallelForEach) {
+    const int n = 100000;
+    for (size_t threads : {0, 1, 3, 64}) {
+        for (size_t grain : {0, 1, 7, 1000000}) {
+            std::vector<int> visited(n);
+            ParallelForEach(Enumerate(visited, 10), [](auto t) {
+                auto [i, x] = t;
+                x += i;
+            }, threads, grain);
+            ASSERT_EQ(visited, std::vector<int>(Range(10, n + 10)));
+        }
+    }
+
+    std::atomic<long long> sum = 0;
+    std::vector<long long> a = Range<long long>(1000);
+    std::vector<long long> b = Range<long long>(1000);
+    ParallelForEach(CartesianProduct(a, Map([](long long x) { return x * x; }, b)), [&sum](auto t) {
+        auto [ai, bi] = t;
+        sum += ai * bi;
+    });
+    ASSERT_EQ(sum, 999LL * 1000 / 2 * (999LL * 1000 * 1999 / 6));
+
+    // not splittable, processed serially
+    std::vector<int> filtered;
+    ParallelForEach(Filter([](int x) { return x % 2; }, Range(10)), [&filtered](int x) {
+        filtered.push_back(x);
+    });
+    ASSERT_EQ(filtered, (std::vector<int>{1, 3, 5, 7, 9}));
+
+    // nested loops and exceptions
+    std::atomic<int> count = 0;
+    ParallelForEach(Range(16), [&count](int) {
+        ParallelForEach(Range(100), [&count](int) {
+            ++count;
+        }, 0, 10);
+    }, 0, 1);
+    ASSERT_EQ(count, 1600);
+    ASSERT_THROW(ParallelForEach(Range(1000), [](int x) {
+        if (x == 500) {
+            throw std::runtime_error("500");
+        }
+    }, 0, 10), std::runtime_error);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, Reduce) {
+    std::vector<long long> a = Range<long long>(100000);
+    ASSERT_EQ(Sum(a), 99999LL * 100000 / 2);
+    ASSERT_EQ(Reduce(a, 5LL), 99999LL * 100000 / 2 + 5);
+    ASSERT_EQ(Reduce(Map([](auto t) { auto [x, y] = t; return x * y; }, Zip(a, a)), 0LL), 99999LL * 100000 * 199999 / 6);
+    ASSERT_EQ(Reduce(Range(5), 1, std::multiplies<>{}), 0);
+    ASSERT_EQ(Reduce(std::vector<int>{}, 7), 7);
+
+    std::vector<int> b = {5, 3, 8, 3, 9, 1, 9};
+    ASSERT_EQ(Min(b), 1);
+    ASSERT_EQ(Max(b), 9);
+    ASSERT_EQ(Max(Filter([](int x) { return x < 9; }, b)), 8);
+    ASSERT_EQ(Sum(Concatenate(b, std::vector<int>{100})), 138);
+    ASSERT_EQ(Sum(Map([](int x) { return -(long long)x; }, Range(1 << 20))), -(((1LL << 20) - 1) << 19));
+
+    // the same result for any number of threads
+    std::vector<float> floats(300000);
+    for (size_t i = 0; i < floats.size(); ++i) {
+        floats[i] = 1.0f / (1 + (i * 7919) % 1000);
+    }
+    const float expected = Sum(floats, 1);
+    for (size_t threads : {2, 3, 8, 0}) {
+        ASSERT_EQ(Sum(floats, threads), expected);
+    }
+    ASSERT_EQ(Min(floats, 4), 0.001f);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, FilterInto) {
+    std::vector<int> a(100003);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = (i * 7919) % 1000;
+    }
+    auto condition = [](int x) { return x % 3 == 0; };
+    std::vector<int> expected;
+    std::copy_if(a.begin(), a.end(), std::back_inserter(expected), condition);
+
+    for (size_t threads : {1, 4}) {
+        std::vector<int> result = {-1};
+        FilterInto(result, condition, a, threads);
+        ASSERT_EQ(result.size(), expected.size() + 1);
+        ASSERT_EQ(result[0], -1);
+        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), result.begin() + 1));
+
+        // not contiguous range, condition is called once per element
+        std::atomic<size_t> calls = 0;
+        std::vector<long long> mapped;
+        FilterInto(mapped, [&calls](long long x) { ++calls; return x % 3 == 0; }, Map([](int x) { return (long long)x; }, a), threads);
+        ASSERT_EQ(calls, a.size());
+        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), mapped.begin(), mapped.end()));
+
+        std::vector<int> copied(a.size());
+        auto end = CopyIf(a, copied.begin(), condition, threads);
+        ASSERT_EQ(end - copied.begin(), (std::ptrdiff_t)expected.size());
+        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), copied.begin()));
+    }
+
+    std::vector<int> small;
+    FilterInto(small, condition, std::vector<int>{});
+    FilterInto(small, condition, Filter([](int x) { return x > 4; }, Range(10)));
+    CopyIf(Range(4), std::back_inserter(small), condition);
+    ASSERT_EQ(small, (std::vector<int>{6, 9, 0, 3}));
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, SizeHintAndMaterialize) {
+    std::vector<int> a = {1, 2, 3};
+    std::list<int> b = {4, 5, 6, 7, 8};
+    auto odd = Filter([](int x) { return x % 2; }, b);
+    auto hint = [](auto&& range) {
+        TSizeHint result = SizeHint(range);
+        return std::make_pair(result.Kind, result.Size);
+    };
+    using TPair = std::pair<ESizeHint, size_t>;
+    ASSERT_EQ(hint(a), TPair(ESizeHint::Exact, 3));
+    ASSERT_EQ(hint(Zip(a, b)), TPair(ESizeHint::Exact, 3));
+    ASSERT_EQ(hint(Zip(b, odd)), TPair(ESizeHint::UpperBound, 5));
+    ASSERT_EQ(hint(Concatenate(a, b)), TPair(ESizeHint::Exact, 8));
+    ASSERT_EQ(hint(Concatenate(b, odd)), TPair(ESizeHint::UpperBound, 10));
+    ASSERT_EQ(hint(CartesianProduct(a, b, Range(2))), TPair(ESizeHint::Exact, 30));
+    ASSERT_EQ(hint(Enumerate(Map([](int x) { return x; }, b))), TPair(ESizeHint::Exact, 5));
+    ASSERT_EQ(hint(Chunks(a, 2)), TPair(ESizeHint::Exact, 2));
+    ASSERT_EQ(hint(Chunks<2>(odd)), TPair(ESizeHint::UpperBound, 2));
+    ASSERT_EQ(hint(MakeMinimalisticContainer()), TPair(ESizeHint::Unknown, 0));
+    ASSERT_EQ(hint(Zip(MakeMinimalisticContainer(), a)), TPair(ESizeHint::UpperBound, 3));
+    ASSERT_EQ(hint(Concatenate(MakeMinimalisticContainer(), a)), TPair(ESizeHint::Unknown, 0));
+    ASSERT_EQ(hint(CartesianProduct(MakeMinimalisticContainer(), std::vector<int>{})), TPair(ESizeHint::Exact, 0));
+
+    auto copied = Materialize(a);
+    ASSERT_EQ(copied, a);
+    auto filtered = Materialize(odd);
+    ASSERT_EQ(filtered, (std::vector<int>{5, 7}));
+    // upper bound of Filter is not reserved
+    ASSERT_LT(filtered.capacity(), 5u);
+    ASSERT_LT(Materialize(Filter([](int x) { return x == 0; }, Range(1, 100000))).capacity(), 100u);
+    auto concatenated = Materialize(Concatenate(a, std::vector<int>{4, 5}));
+    ASSERT_EQ(concatenated, (std::vector<int>{1, 2, 3, 4, 5}));
+    ASSERT_EQ(concatenated.capacity(), 5u);
+    auto zipped = Materialize(Zip(a, b));
+    static_assert(std::is_same_v<decltype(zipped), std::vector<std::tuple<int, int>>>);
+    ASSERT_EQ(zipped, (std::vector<std::tuple<int, int>>{{1, 4}, {2, 5}, {3, 6}}));
+    ASSERT_EQ(zipped.capacity(), 3u);
+    ASSERT_EQ(Materialize<std::set<int>>(Concatenate(b, a)), (std::set<int>{1, 2, 3, 4, 5, 6, 7, 8}));
+    ASSERT_EQ(Materialize<std::list<int>>(MakeMinimalisticContainer()), (std::list<int>{0, 1, 2}));
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, Slice) {
+    // a[start:stop:step] of python
+    auto pythonSlice = [](const std::vector<int>& a, std::optional<int> start, std::optional<int> stop, int step) {
+        const int size = a.size();
+        auto resolve = [&](std::optional<int> index, int byDefault, int lower, int upper) {
+            if (!index) {
+                return byDefault;
+            }
+            int result = *index < 0 ? *index + size : *index;
+            return std::max(lower, std::min(result, upper));
+        };
+        std::vector<int> result;
+        if (step > 0) {
+            for (int i = resolve(start, 0, 0, size), last = resolve(stop, size, 0, size); i < last; i += step) {
+                result.push_back(a[i]);
+            }
+        } else {
+            for (int i = resolve(start, size - 1, -1, size - 1), last = resolve(stop, -1, -1, size - 1); i > last; i += step) {
+                result.push_back(a[i]);
+            }
+        }
+        return result;
+    };
+
+    std::vector<std::optional<int>> indexes = {std::nullopt};
+    for (int i = -8; i <= 8; ++i) {
+        indexes.push_back(i);
+    }
+    for (int size = 0; size <= 6; ++size) {
+        std::vector<int> a = Range(10, 10 + size);
+        std::list<int> b(a.begin(), a.end());
+        for (auto start : indexes) {
+            for (auto stop : indexes) {
+                for (int step : {-3, -2, -1, 1, 2, 3}) {
+                    std::optional<std::ptrdiff_t> from, to;
+                    if (start) {
+                        from = *start;
+                    }
+                    if (stop) {
+                        to = *stop;
+                    }
+                    const auto expected = pythonSlice(a, start, stop, step);
+                    auto slice = Slice(a, from, to, step);
+                    ASSERT_EQ(slice.size(), expected.size());
+                    ASSERT_EQ(std::vector<int>(slice.begin(), slice.end()), expected);
+                    for (size_t i = 0; i < expected.size(); ++i) {
+                        ASSERT_EQ(slice[i], expected[i]);
+                    }
+                    if (step > 0) {
+                        std::vector<int> fromList;
+                        for (int x : Slice(b, from, to, step)) {
+                            fromList.push_back(x);
+                        }
+                        ASSERT_EQ(fromList, expected);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<int> a = Range(10);
+    auto reversed = Slice(Zip(a, Map([](int x) { return x * x; }, a)), {}, {}, -3);
+    static_assert(decltype(reversed)::RandomAccess);
+    ASSERT_EQ(reversed.end() - reversed.begin(), 4);
+    ASSERT_EQ(std::get<1>(*(reversed.begin() + 1)), 36);
+    ASSERT_TRUE(SizeHint(reversed).IsExact());
+
+    // unknown size: skips and stops early
+    size_t calls = 0;
+    std::list<int> b(a.begin(), a.end());
+    auto counted = Filter([&calls](int) { ++calls; return true; }, b);
+    std::vector<int> sliced;
+    for (int x : Slice(counted, 2, 7, 2)) {
+        sliced.push_back(x);
+    }
+    ASSERT_EQ(sliced, (std::vector<int>{2, 4, 6}));
+    ASSERT_EQ(calls, 7u);
+    ASSERT_EQ(SizeHint(Slice(counted, 2, 7, 2)).Size, 3u);
+    sliced.clear();
+    for (int x : Slice(counted, 7)) {
+        sliced.push_back(x);
+    }
+    ASSERT_EQ(sliced, (std::vector<int>{7, 8, 9}));
+
+    // rejected in release builds too
+    ASSERT_THROW(Slice(a, {}, {}, 0), std::invalid_argument);
+    ASSERT_THROW(Slice(b, {}, {}, -1), std::invalid_argument);
+    ASSERT_THROW(Slice(counted, {}, {}, -1), std::invalid_argument);
+    ASSERT_THROW(Slice(counted, -2), std::invalid_argument);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, SteppedRange) {
+    auto check = [](auto range, const std::vector<int>& expected) {
+        ASSERT_EQ((size_t)range.size(), expected.size());
+        ASSERT_EQ(range.end() - range.begin(), (std::ptrdiff_t)expected.size());
+        ASSERT_EQ(std::vector<int>(range.begin(), range.end()), expected);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            auto it = range.begin();
+            it += i;
+            ASSERT_EQ(*it, expected[i]);
+            ASSERT_EQ(*(range.begin() + i), expected[i]);
+            ASSERT_EQ(range.begin()[i], expected[i]);
+            ASSERT_EQ(*(range.end() - (expected.size() - i)), expected[i]);
+            ASSERT_TRUE(range.begin() <= it && it < range.end());
+        }
+        std::vector<int> backward;
+        for (auto it = range.end(); it != range.begin();) {
+            backward.push_back(*--it);
+        }
+        ASSERT_EQ(std::vector<int>(backward.rbegin(), backward.rend()), expected);
+    };
+    check(Range(0, 10, 3), {0, 3, 6, 9});
+    check(Range(0, 9, 3), {0, 3, 6});
+    check(Range(10, 0, -3), {10, 7, 4, 1});
+    check(Range(5, 5, 2), {});
+    check(Range<3>(0, 10), {0, 3, 6, 9});
+    check(Range<-4>(10, -1), {10, 6, 2});
+
+    auto stepped = Range<4>(0, 16);
+    static_assert(sizeof(stepped.begin()) == sizeof(int));
+    ASSERT_EQ(std::lower_bound(stepped.begin(), stepped.end(), 7) - stepped.begin(), 2);
+    ASSERT_EQ(Sum(Range(0, 1000, 4)), Sum(Range<4>(0, 1000)));
+    std::vector<int> zipped;
+    for (auto [i, j] : Zip(Range(0, 10, 2), Range<5>(0, 100))) {
+        zipped.push_back(i + j);
+    }
+    ASSERT_EQ(zipped, (std::vector<int>{0, 7, 14, 21, 28}));
+
+    ASSERT_THROW(Range(0, 10, 0), std::invalid_argument);
+    // finish is computed by the step that iterators use
+    ASSERT_THROW((NPrivate::TSteppedXRange<int, 3>(0, 10, 2)), std::invalid_argument);
+    check(NPrivate::TSteppedXRange<int, 3>(0, 10, 3), {0, 3, 6, 9});
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, ReversedAdaptors) {
+    using TPair = std::pair<size_t, int>;
+    std::vector<int> a = {1, 2, 3, 4, 5};
+    std::list<int> l = {10, 20, 30};
+    std::vector<int> empty;
+
+    auto collect = [](auto&& range) {
+        std::vector<TPair> result;
+        for (auto [i, x] : range) {
+            result.emplace_back(i, x);
+        }
+        return result;
+    };
+    auto values = [](auto&& range) {
+        return std::vector<int>(range.begin(), range.end());
+    };
+    // the shortest input defines the last element of zip
+    ASSERT_EQ(collect(Reversed(Zip(a, l))), (std::vector<TPair>{{3, 30}, {2, 20}, {1, 10}}));
+    ASSERT_EQ(collect(Reversed(Zip(l, std::list<int>{7, 8}))), (std::vector<TPair>{{20, 8}, {10, 7}}));
+    ASSERT_EQ(collect(Reversed(Zip(empty, l))), std::vector<TPair>{});
+    // indexes are the original ones
+    ASSERT_EQ(collect(Reversed(Enumerate(l))), (std::vector<TPair>{{2, 30}, {1, 20}, {0, 10}}));
+    ASSERT_EQ(collect(Reversed(Enumerate(a, 1))).front(), TPair(5, 5));
+
+    auto square = [](int x) { return x * x; };
+    ASSERT_EQ(values(Reversed(Map(square, l))), (std::vector<int>{900, 400, 100}));
+
+    std::vector<int> big(300);
+    for (size_t i = 0; i < big.size(); ++i) {
+        big[i] = i;
+    }
+    auto isRare = [](int x) { return x % 97 == 1 || x == 299; };
+    ASSERT_EQ(values(Reversed(Filter(isRare, big))), (std::vector<int>{299, 292, 195, 98, 1}));
+    ASSERT_EQ(values(Reversed(Filter([](int x) { return x < 0; }, big))), std::vector<int>{});
+    std::list<int> bigList(big.begin(), big.end());
+    ASSERT_EQ(values(Reversed(Filter(isRare, bigList))), (std::vector<int>{299, 292, 195, 98, 1}));
+    ASSERT_EQ(values(Reversed(Filter([](int x) { return x > 100; }, Map(square, l)))), (std::vector<int>{900, 400}));
+
+    ASSERT_EQ(values(Reversed(Concatenate(a, empty, l))), (std::vector<int>{30, 20, 10, 5, 4, 3, 2, 1}));
+    ASSERT_EQ(values(Reversed(Concatenate(empty, l, empty))), (std::vector<int>{30, 20, 10}));
+    ASSERT_EQ(values(Reversed(Concatenate(empty, empty))), std::vector<int>{});
+
+    // iterators go forth and back
+    auto filtered = Filter(isRare, big);
+    auto it = filtered.begin();
+    ++it;
+    ++it;
+    --it;
+    ASSERT_EQ(*it, 98);
+    --it;
+    ASSERT_EQ(*it, 1);
+    auto zipped = Zip(l, a);
+    auto last = zipped.end();
+    --last;
+    ASSERT_EQ(std::get<1>(*last), 3);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, Pipe) {
+    std::vector<int> a = {1, 2, 3, 4, 5, 6};
+    std::list<int> l = {3, 1, 2};
+    auto values = [](auto&& range) {
+        return std::vector<int>(range.begin(), range.end());
+    };
+    auto square = [](int x) { return x * x; };
+    auto isEven = [](int x) { return x % 2 == 0; };
+
+    ASSERT_EQ(a | Map(square) | Filter(isEven) | Sum(), 4 + 16 + 36);
+    ASSERT_EQ(values(a | Map(square) | Map([](int x) { return x + 1; })), (std::vector<int>{2, 5, 10, 17, 26, 37}));
+    ASSERT_EQ(values(l | Filter([](int x) { return x > 1; }) | Filter([](int x) { return x < 3; })), std::vector<int>{2});
+    ASSERT_EQ(values(a | Reversed() | Reversed()), a);
+    ASSERT_EQ(values(l | Reversed() | Map(square)), (std::vector<int>{4, 1, 9}));
+    ASSERT_EQ(a | Filter(isEven) | Max(), 6);
+    ASSERT_EQ(l | Min(), 1);
+    ASSERT_EQ((std::vector<int>{7, 8} | Map(square) | Materialize()), (std::vector<int>{49, 64}));
+    for (auto [i, x] : l | Enumerate()) {
+        ASSERT_EQ(x, *std::next(l.begin(), i));
+    }
+
+    // chains are rewritten into one adaptor
+    auto mapped = a | Map(square) | Map(square) | Map(square);
+    static_assert(std::is_same_v<decltype(mapped.SourceStorage()), TAutoEmbedOrPtrPolicy<std::vector<int>&>&>);
+    ASSERT_EQ(*(mapped.begin() + 1), 256);
+    ASSERT_EQ(sizeof(mapped.begin()), sizeof(Map(square, a).begin()));
+    auto filtered = a | Filter(isEven) | Filter([](int x) { return x > 2; });
+    ASSERT_EQ(values(filtered), (std::vector<int>{4, 6}));
+    static_assert(std::is_same_v<std::decay_t<decltype(std::declval<decltype(filtered)&>().Storage_.Ptr())>, std::vector<int>*>);
+    static_assert(std::is_same_v<decltype(a | Reversed() | Reversed()), std::vector<int>&>);
+    static_assert(std::is_same_v<decltype(std::list<int>{} | Reversed() | Reversed()), std::list<int>>);
+
+    // an lvalue adaptor is referenced by the fused one
+    auto filteredOnce = a | Filter(isEven);
+    ASSERT_EQ(values(filteredOnce | Filter([](int x) { return x < 6; })), (std::vector<int>{2, 4}));
+    ASSERT_EQ(values(filteredOnce), (std::vector<int>{2, 4, 6}));
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, ForEachBlock) {
+    std::vector<int> a(3000);
+    std::vector<int> b(2500);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = i;
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+        b[i] = 3 * i;
+    }
+    std::list<int> l(b.begin(), b.begin() + 100);
+
+    auto byBlocks = [](auto&& range) {
+        std::vector<std::decay_t<decltype(*range.begin())>> result;
+        std::vector<size_t> sizes;
+        ForEachBlock(range, [&](const auto& block) {
+            sizes.push_back(block.SelectedCount());
+            block.ForEach([&](auto&& x) {
+                result.push_back(x);
+            });
+        });
+        return std::pair{result, sizes};
+    };
+    auto byIterators = [](auto&& range) {
+        std::vector<std::decay_t<decltype(*range.begin())>> result;
+        for (auto&& x : range) {
+            result.push_back(x);
+        }
+        return result;
+    };
+
+    auto isOdd = [](int x) { return x % 2 == 1; };
+    auto sum = [](auto t) { return std::get<0>(t) + std::get<1>(t); };
+    auto query = Filter([](int x) { return x % 8 == 4; }, Map(sum, Zip(a, b)));
+    ASSERT_EQ(byBlocks(query).first, byIterators(query));
+    ASSERT_EQ(byBlocks(query).second, (std::vector<size_t>{512, 512, 226}));
+
+    // concatenate refills the block across the borders of containers
+    auto concatenated = Concatenate(a, l, b);
+    ASSERT_EQ(byBlocks(concatenated).first, byIterators(concatenated));
+    ASSERT_EQ(byBlocks(concatenated).second, (std::vector<size_t>{1024, 1024, 1024, 1024, 1024, 480}));
+    auto mapped = Map([](int x) { return x / 2; }, Concatenate(b, a));
+    ASSERT_EQ(byBlocks(mapped).first, byIterators(mapped));
+
+    // filter of filter refines the selection vector
+    auto twice = Filter([](int x) { return x % 3 == 0; }, Filter(isOdd, l));
+    ASSERT_EQ(byBlocks(twice).first, byIterators(twice));
+    ASSERT_EQ(byBlocks(Filter([](int x) { return x < 0; }, a)).second, std::vector<size_t>{});
+
+    // zip of a filter is read by iterators
+    auto zipped = Zip(Filter(isOdd, a), l);
+    auto blocks = byBlocks(zipped).first;
+    ASSERT_EQ(blocks.size(), 100u);
+    ASSERT_EQ(std::get<0>(blocks[99]), 199);
+    ASSERT_EQ(std::get<1>(blocks[99]), 297);
+    auto enumerated = Map([](auto t) { return std::get<0>(t) * std::get<1>(t); }, Enumerate(l));
+    ASSERT_EQ(byBlocks(enumerated).first, byIterators(enumerated));
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, FlattenNested) {
+    std::vector<int> a = {1, 2};
+    std::vector<std::tuple<int, std::pair<int, std::string>>> nested = {{1, {2, "x"}}, {3, {4, "y"}}};
+
+    using TFlat = decltype(*Flatten(Enumerate(Zip(a, nested))).begin());
+    static_assert(std::is_same_v<std::tuple_element_t<1, TFlat>, int&>);
+    static_assert(std::is_same_v<std::tuple_element_t<4, TFlat>, std::string>);
+    static_assert(std::tuple_size_v<TFlat> == 5);
+
+    // values of nested tuples are copied out of an lvalue container, not moved
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<std::string> strings;
+        for (auto [x, y, s] : Flatten(nested)) {
+            strings.push_back(s);
+        }
+        ASSERT_EQ(strings, (std::vector<std::string>{"x", "y"}));
+    }
+    for (auto [i, x, k, y, s] : Flatten(Enumerate(Zip(a, nested)))) {
+        ASSERT_EQ(k, int(2 * i + 1));
+        x = 0;
+    }
+    ASSERT_EQ(a, (std::vector<int>{0, 0}));
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, LightTuple) {
+    int x = 1;
+    NPrivate::TLightTuple<int, int&, std::string> t{2, x, "a"};
+    auto& [i, r, s] = t;
+    ASSERT_EQ(i, 2);
+    r = 3;
+    ASSERT_EQ(x, 3);
+    NPrivate::Get<2>(t) += "b";
+    ASSERT_EQ(s, "ab");
+    static_assert(std::is_same_v<std::tuple_element_t<1, decltype(t)>, int&>);
+    ASSERT_EQ(t.ToTuple(), (std::tuple<int, int&, std::string>{2, x, "ab"}));
+
+    NPrivate::TLightTuple<std::vector<int>> single{std::vector<int>{1, 2}};
+    auto copy = single;
+    ASSERT_EQ(NPrivate::Get<0>(copy).size(), 2u);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, ConstexprToArray) {
+    constexpr auto squares = ToArray<256>(Map([](int x) { return x * x; }, Range(256)));
+    static_assert(squares.size() == 256);
+    static_assert(squares[0] == 0 && squares[15] == 225 && squares[255] == 255 * 255);
+
+    // operator== of std::array is not constexpr in C++17
+    constexpr auto equal = [](const auto& a, const auto& b) {
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (a[i] != b[i]) {
+                return false;
+            }
+        }
+        return a.size() == b.size();
+    };
+    static constexpr std::array<int, 6> values{3, 1, 4, 1, 5, 9};
+    constexpr auto odd = ToArray<5>(Filter([](int x) { return x % 2 == 1; }, values));
+    static_assert(equal(odd, std::array<int, 5>{3, 1, 1, 5, 9}));
+    constexpr auto oddByMask = ToArray<5>(FilterBlockMask([](int x) { return x % 2 == 1; }, values));
+    static_assert(equal(oddByMask, odd));
+    constexpr auto bigSquares = ToArray<3>(Filter([](int x) { return x > 10; }, Map([](int x) { return x * x; }, values)));
+    static_assert(equal(bigSquares, std::array<int, 3>{16, 25, 81}));
+    constexpr auto reversed = ToArray<6>(Reversed(values));
+    static_assert(equal(reversed, std::array<int, 6>{9, 5, 1, 4, 1, 3}));
+
+    constexpr auto weighted = ToArray<6>(Map([](auto p) {
+        auto [i, x] = p;
+        return int(i) * x;
+    }, Enumerate(values)));
+    static_assert(equal(weighted, std::array<int, 6>{0, 1, 8, 3, 20, 45}));
+    constexpr auto sums = ToArray<3>(Map([](auto p) {
+        auto [x, y] = p;
+        return x + y;
+    }, Zip(values, Range(3))));
+    static_assert(equal(sums, std::array<int, 3>{3, 2, 6}));
+    constexpr auto piped = ToArray<2>(values | Map([](int x) { return x + 1; }) | Filter([](int x) { return x > 5; }));
+    static_assert(equal(piped, std::array<int, 2>{6, 10}));
+
+    // functors with const operator() may have state, mutable ones are used at runtime only
+    constexpr auto scaled = ToArray<3>(Map([scale = 3](int x) { return x * scale; }, Range(3)));
+    static_assert(equal(scaled, std::array<int, 3>{0, 3, 6}));
+    auto everySecond = [calls = 0](int) mutable { return ++calls % 2 == 0; };
+    static_assert(!NPrivate::TIsConstSafe<decltype(everySecond)>::value);
+    const auto filtered = Filter(std::move(everySecond), values);
+    ASSERT_EQ(ToArray<3>(filtered), (std::array<int, 3>{1, 1, 9}));
+    // stateless, but not callable as const: held as mutable too
+    auto negate = [](int x) mutable { return -x; };
+    ASSERT_EQ(ToArray<2>(Map(std::move(negate), Range(1, 3))), (std::array<int, 2>{-1, -2}));
+    // parts of a const range are taken as const by the pipe
+    const auto incremented = Map([](int x) { return x + 1; }, Range(3));
+    ASSERT_EQ(ToArray<3>(incremented | Map([](int x) { return x * 2; })), (std::array<int, 3>{2, 4, 6}));
+
+    // the same chains at runtime
+    ASSERT_EQ(ToArray<3>(Map([](auto p) { return std::get<1>(p); }, Zip(values, Range(3)))), (std::array<int, 3>{0, 1, 2}));
+    ASSERT_EQ(ToArray<5>(Filter([](int x) { return x % 2 == 1; }, values)), odd);
+    ASSERT_THROW(ToArray<4>(Filter([](int x) { return x % 2 == 1; }, values)), std::invalid_argument);
+    ASSERT_THROW(ToArray<7>(values), std::invalid_argument);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, StaticExtent) {
+    using NPrivate::DynamicExtent;
+    using NPrivate::StaticExtent;
+    std::array<float, 3> p{1, 2, 3};
+    const float q[3] = {4, 5, 6};
+    int r[2] = {7, 8};
+    std::vector<int> v{1, 2, 3};
+    auto square = [](auto x) { return x * x; };
+
+    static_assert(StaticExtent<decltype(p)>() == 3);
+    static_assert(StaticExtent<decltype(q)&>() == 3);
+    static_assert(StaticExtent<decltype(v)>() == DynamicExtent);
+    static_assert(decltype(Map(square, p))::Extent == 3);
+    static_assert(decltype(Enumerate(q))::Extent == 3);
+    static_assert(StaticExtent<decltype(Reversed(Map(square, p)))>() == 3);
+    static_assert(decltype(Zip(p, q, r))::Extent == 2);
+    static_assert(decltype(Zip(p, v))::Extent == DynamicExtent);
+    static_assert(decltype(Zip(std::array<int, 0>{}, v))::Extent == 0);
+    static_assert(decltype(Concatenate(p, q))::Extent == 6);
+    static_assert(decltype(Concatenate(p, v))::Extent == DynamicExtent);
+    static_assert(decltype(CartesianProduct(p, r))::Extent == 6);
+    auto all = [](float) { return true; };
+    static_assert(NPrivate::StaticExtent<decltype(Filter(all, p))>() == DynamicExtent);
+    static_assert(NPrivate::SameStaticExtents<decltype(p)&, decltype(q)&, decltype(v)&>());
+    static_assert(!NPrivate::SameStaticExtents<decltype(p)&, decltype(r)&>());
+
+    // materialized without heap, the size comes from the extent
+    std::array<float, 3> sum = ToArray(Map([](auto t) {
+        auto [x, y] = t;
+        return x + y;
+    }, ZipEqual(p, q)));
+    ASSERT_EQ(sum, (std::array<float, 3>{5, 7, 9}));
+    ASSERT_EQ(ToArray(Concatenate(r, r)), (std::array<int, 4>{7, 8, 7, 8}));
+
+    // dynamic lengths are checked at runtime, unknown ones are not
+    ASSERT_EQ(ZipEqual(p, v).size(), 3u);
+    ASSERT_THROW(ZipEqual(v, r), std::invalid_argument);
+    ASSERT_THROW(ZipEqual(v, Range(4)), std::invalid_argument);
+    std::size_t zipped = 0;
+    for (auto [x, i] : ZipEqual(Filter([](int x) { return x > 1; }, v), Range(5))) {
+        ASSERT_EQ(x, i + 2);
+        ++zipped;
+    }
+    ASSERT_EQ(zipped, 2u);
+
+    // small extents are iterated by the unrolled loop
+    float dot = 0;
+    ForEach(Zip(p, q), [&dot](auto t) {
+        auto [x, y] = t;
+        dot += x * y;
+    });
+    ASSERT_EQ(dot, 32);
+    std::vector<std::pair<std::size_t, int>> visited;
+    ForEach(Enumerate(r), [&visited](auto t) {
+        auto [i, x] = t;
+        visited.push_back({i, x});
+    });
+    ASSERT_EQ(visited, (std::vector<std::pair<std::size_t, int>>{{0, 7}, {1, 8}}));
+    ASSERT_EQ(Zip(p, r).size(), 2u);
+    ASSERT_EQ(CartesianProduct(p, r).size(), 6u);
+}
+#endif
+
+#if !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(think_cell_REALISATION)
 TEST_F(TestFunctools, CompileCartesianProduct) {
     auto container = std::vector{1, 2, 3};
     TestViewCompileability(CartesianProduct(container, container));
@@ -561,7 +1622,7 @@ TEST_F(TestFunctools, Concatenate2) {
         ASSERT_EQ(c, d);
     }
 
-    #if !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+    #if !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(think_cell_REALISATION)
     {
         std::vector<int32_t> a = {1, 2, 3, 4};
         std::vector<int32_t> c;
@@ -574,7 +1635,7 @@ TEST_F(TestFunctools, Concatenate2) {
 }
 #endif
 
-#if !defined(baseline_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+#if !defined(baseline_REALISATION) && !defined(coroutine_REALISATION) && !defined(baseline_copy_REALISATION) && !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(std_ranges_REALISATION) && !defined(think_cell_REALISATION)
 TEST_F(TestFunctools, CompileConcatenate) {
     auto container = std::vector{1, 2, 3};
     TestViewCompileability(Concatenate(container, container));
@@ -592,6 +1653,67 @@ TEST_F(TestFunctools, CompileConcatenate) {
 #endif
 
 
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, ConcatenateSegmented) {
+    std::vector<int> a = {1, 2, 3};
+    std::vector<int> b;
+    std::vector<int> c = {4, 2, 5};
+    const auto abc = Concatenate(a, b, c);
+    static_assert(decltype(abc)::Segmented);
+    ASSERT_EQ(std::tuple_size_v<decltype(abc.Segments())>, 3u);
+
+    ASSERT_EQ(Accumulate(abc, 0), 17);
+    ASSERT_EQ(Accumulate(abc, 1, std::multiplies<>{}), 240);
+    ASSERT_EQ(Count(abc, 2), 2u);
+    ASSERT_EQ(Count(abc, 7), 0u);
+
+    std::vector<int> copied;
+    Copy(abc, std::back_inserter(copied));
+    ASSERT_EQ(copied, (std::vector{1, 2, 3, 4, 2, 5}));
+
+    auto it = Find(abc, 5);
+    ASSERT_TRUE(it != abc.end());
+    ASSERT_EQ(*it, 5);
+    ++it;
+    ASSERT_TRUE(it == abc.end());
+    it = Find(abc, 4);
+    ASSERT_EQ(*it, 4);
+    ++it;
+    ASSERT_EQ(*it, 2);
+    ASSERT_TRUE(Find(abc, 0) == abc.end());
+    ASSERT_TRUE(Find(Concatenate(b, b), 0) == Concatenate(b, b).end());
+
+    // not segmented ranges work too
+    auto minimalistic = Concatenate(MakeMinimalisticContainer(), MakeMinimalisticContainer());
+    static_assert(!decltype(minimalistic)::Segmented);
+    ASSERT_EQ(Accumulate(minimalistic, 0), 6);
+    ASSERT_EQ(Count(minimalistic, 1), 2u);
+    ASSERT_EQ(*Find(minimalistic, 2), 2);
+    auto isOdd = [](int x) { return bool(x & 1); };
+    ASSERT_EQ(Accumulate(Filter(isOdd, abc), 0), 9);
+}
+#endif
+
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, ConcatenateIteratorIncrements) {
+    std::vector<int> a = {1, 2};
+    std::list<int> b = {3};
+    auto ab = Concatenate(a, b);
+    static_assert(std::is_same_v<std::iterator_traits<decltype(ab.begin())>::iterator_category, std::bidirectional_iterator_tag>);
+    auto it = ab.begin();
+    ASSERT_EQ(*it++, 1);
+    ASSERT_EQ(*++it, 3);
+    ASSERT_EQ(*it--, 3);
+    ASSERT_EQ(*--it, 1);
+    ASSERT_EQ(*std::prev(ab.end()), 3);
+    ASSERT_EQ(std::distance(ab.begin(), ab.end()), 3);
+
+    std::vector<int> reversed;
+    std::reverse_copy(ab.begin(), ab.end(), std::back_inserter(reversed));
+    ASSERT_EQ(reversed, (std::vector<int>{3, 2, 1}));
+}
+#endif
+
 #if !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
 TEST_F(TestFunctools, Flatten) {
     {
@@ -692,7 +1814,59 @@ TEST_F(TestFunctools, Combo) {
 }
 #endif
 
-#if !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION)
+#if defined(ordinary_view_REALISATION)
+TEST_F(TestFunctools, ForEach) {
+    // push-based iteration must visit exactly the same values as range-based for
+    auto check = [](auto&& range) {
+        using TValue = std::decay_t<decltype(*range.begin())>;
+        std::vector<TValue> pulled;
+        for (auto x : range) {
+            pulled.push_back(x);
+        }
+        std::vector<TValue> pushed;
+        ForEach(range, [&pushed](auto x) {
+            pushed.push_back(x);
+        });
+        ASSERT_EQ(pulled, pushed);
+    };
+
+    std::vector a = {1, 2, 3, 4, 5};
+    std::vector b = {10, 20, 30};
+    std::vector<int> empty;
+    std::set<int> c = {7, 8};
+    auto isOdd = [](int x) { return bool(x & 1); };
+    auto sqr = [](int x) { return x * x; };
+
+    check(Zip(a, b));
+    check(Zip(a, c));
+    check(Zip(a, b, empty));
+    check(Enumerate(b));
+    check(Enumerate(c));
+    check(Filter(isOdd, a));
+    check(Filter(isOdd, empty));
+    check(Map(sqr, a));
+    check(Map(sqr, c));
+    check(Concatenate(a, empty, b));
+    check(Concatenate(c, std::set<int>{1, 9}));
+    check(Concatenate(empty, empty));
+    check(CartesianProduct(a, b));
+    check(CartesianProduct(a, empty, b));
+    check(CartesianProduct(c, b, c));
+    check(Flatten(Enumerate(Zip(a, Filter(isOdd, Concatenate(a, b))))));
+    check(Enumerate(Reversed(a)));
+    check(CartesianProduct(Range(3), Range(2, 4)));
+    check(Zip(MakeMinimalisticContainer(), Concatenate(MakeMinimalisticContainer(), b)));
+
+    std::vector d = {0, 0, 0};
+    ForEach(Enumerate(d), [](auto t) {
+        auto [i, x] = t;
+        x = i;
+    });
+    ASSERT_TRUE((d == std::vector{0, 1, 2}));
+}
+#endif
+
+#if !defined(boost_range_REALISATION) && !defined(range_v3_REALISATION) && !defined(think_cell_REALISATION) && !defined(coroutine_REALISATION)
 TEST_F(TestFunctools, CopyIterator) {
     std::vector a = {1, 2, 3, 4};
     std::vector b = {4, 5, 6, 7};
@@ -774,6 +1948,49 @@ TEST_F(TestFunctools, CopyIterator) {
 
 #endif // #if !defined(native_REALISATION)
 
+#if defined(native_simd_REALISATION)
+
+#include <functools.h>
+
+#include <vector>
+
+TEST(TestNativeSimd, KernelsMatchScalarLoops) {
+    std::vector<int> a, b;
+    for (int i = 0; i < 100; ++i) {
+        a.push_back(i * i * i ^ i);
+        b.push_back(i * i * i | -i);
+    }
+    // sizes cover empty input and tails after the vector part
+    for (size_t n : {0, 1, 7, 8, 9, 15, 16, 17, 33, 100}) {
+        for (int x : {0, 5, -1}) {
+            unsigned sum = 0, odd = 0, product = 0, indexProduct = 0, outerProduct = 0;
+            for (size_t j = 0; j < n; ++j) {
+                sum += x ^ a[j];
+                odd += (a[j] & 1) ? x ^ a[j] : 0;
+                product += x ^ (unsigned)a[j] * b[j];
+                indexProduct += x ^ j * a[j];
+                for (size_t k = 0; k < 10; ++k) {
+                    outerProduct += x ^ (unsigned)a[j] * b[k];
+                }
+            }
+            ASSERT_EQ(NNativeSimd::SumXor(a.data(), n, x), (int)sum);
+            ASSERT_EQ(NNativeSimd::SumXorOdd(a.data(), n, x), (int)odd);
+            ASSERT_EQ(NNativeSimd::SumXorProduct(a.data(), b.data(), n, x), (int)product);
+            ASSERT_EQ(NNativeSimd::SumXorIndexProduct(a.data(), n, x), (int)indexProduct);
+            ASSERT_EQ(NNativeSimd::SumXorOuterProduct(a.data(), n, b.data(), 10, x), (int)outerProduct);
+            // versions of other instruction sets than the dispatched one
+            ASSERT_EQ(NNativeSimd::NSse41::SumXor(a.data(), n, x), sum);
+            ASSERT_EQ(NNativeSimd::NSse41::SumXorOdd(a.data(), n, x), odd);
+            ASSERT_EQ(NNativeSimd::NSse41::SumXorProduct(a.data(), b.data(), n, x), product);
+            ASSERT_EQ(NNativeSimd::NSse41::SumXorIndexProduct(a.data(), n, x), indexProduct);
+            ASSERT_EQ(NNativeSimd::NScalar::SumXorIndexProduct(a.data(), n, x), indexProduct);
+            ASSERT_EQ(NNativeSimd::NSse41::SumXorScaled(a.data(), n, b[1], x), NNativeSimd::NScalar::SumXorScaled(a.data(), n, b[1], x));
+        }
+    }
+}
+
+#endif
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);